@@ -0,0 +1,55 @@
+#include "bench.h"
+using namespace scaly;
+namespace scaly {
+
+extern __thread _Page* __CurrentPage;
+extern __thread _Task* __CurrentTask;
+
+}
+
+// Checks and measurements of the runtime which need more than a Scaly program.
+// Run as bench <name>, or without a name for all of them.
+struct _Bench {
+    const char* name;
+    int (*run)();
+};
+
+static const _Bench benches[] = {
+    { "pool", bench::pool },
+    { "hash", bench::hash },
+    { "map", bench::map },
+    { "string", bench::strings },
+    { "persistent", bench::persistent },
+    { "btree", bench::btree },
+    { "sort", bench::sort },
+    { "future", bench::future },
+    { "queue", bench::queue },
+    { "workers", bench_workers },
+};
+
+int main(int argc, char** argv) {
+    // Allocate the root page for the main thread
+    _Page* page = 0;
+    posix_memalign((void**)&page, _pageSize, _pageSize * _maxStackPages);
+    if (!page)
+        return -1;
+    page->reset();
+    __CurrentPage = page;
+
+    _Task* task = new(page) _Task();
+    __CurrentTask = task;
+
+    int ret = 0;
+    for (size_t i = 0; i < sizeof benches / sizeof benches[0]; i++) {
+        if (argc > 1 && strcmp(argv[1], benches[i].name))
+            continue;
+        printf("%s\n", benches[i].name);
+        if (benches[i].run()) {
+            printf("%s FAILED\n", benches[i].name);
+            ret = 1;
+        }
+    }
+
+    __CurrentTask->dispose();
+    return ret;
+}
@@ -0,0 +1,25 @@
+#ifndef __scaly__bench__
+#define __scaly__bench__
+
+#include "Scaly.h"
+
+using namespace scaly;
+namespace bench {
+
+// Each returns 0 if all of its checks held
+int pool();
+int hash();
+int map();
+int strings();
+int persistent();
+int btree();
+int sort();
+int future();
+int queue();
+
+}
+
+// Of the C runtime
+extern "C" int bench_workers();
+
+#endif // __scaly__bench__
@@ -0,0 +1,196 @@
+#include "bench.h"
+#include <time.h>
+#include <map>
+#include <vector>
+#include <string>
+#include <algorithm>
+using namespace scaly;
+
+namespace bench {
+
+static double now() {
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// splitmix64, so that each run sees the same orders
+static uint64_t nextRandom(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+// Keys shorter than the eight bytes kept in the nodes, keys which tie on those
+// and keys which start with other keys, the empty one among them
+static string* keyOf(_Page* _p, size_t i) {
+    char name[32];
+    if (!i)
+        return new(_p) string("");
+    snprintf(name, sizeof name, i % 3 ? "identifier%zu" : "x%zu", i);
+    return new(_p) string(name);
+}
+
+typedef std::map<std::string, size_t*> _Expected;
+
+static std::string textOf(string* key) {
+    return std::string(key->getNativeString(), key->getLength());
+}
+
+// The tree holds what expected holds, in the same order, also within ranges
+// which start and end at keys of the tree and between them
+static size_t compare(_BTreeMap<string, size_t>* tree, _Expected& expected, std::vector<string*>& sorted, _Page* _p) {
+    size_t wrong = tree->length() != expected.size();
+    _Expected::iterator next = expected.begin();
+    tree->forEach([&](string* key, size_t* value) {
+        wrong += next == expected.end() || textOf(key) != next->first || value != next->second;
+        if (next != expected.end())
+            ++next;
+    });
+    wrong += next != expected.end();
+
+    for (size_t i = 0; i < sorted.size(); i++) {
+        wrong += tree->get(sorted[i]) != expected[textOf(sorted[i])] || !tree->contains(sorted[i]);
+
+        // A key which sorts right after this one and is not in the tree
+        std::string absent = textOf(sorted[i]) + "!";
+        wrong += tree->get(absent.data(), absent.size()) != 0;
+    }
+
+    size_t step = sorted.size() / 7 + 1;
+    for (size_t from = 0; from <= sorted.size(); from += step) {
+        for (size_t to = from; to <= sorted.size(); to += step) {
+            string* fromKey = from < sorted.size() ? sorted[from] : 0;
+            string* toKey = to < sorted.size() ? sorted[to] : 0;
+            _Expected::iterator first = fromKey ? expected.lower_bound(textOf(fromKey)) : expected.begin();
+            _Expected::iterator last = toKey ? expected.lower_bound(textOf(toKey)) : expected.end();
+            tree->forEachInRange(fromKey, toKey, [&](string* key, size_t* value) {
+                wrong += first == last || textOf(key) != first->first;
+                if (first != last)
+                    ++first;
+            });
+            wrong += first != last;
+
+            // A lower bound which is not a key of the tree
+            if (fromKey && to > from) {
+                string* between = new(_p) string((textOf(fromKey) + "!").c_str());
+                first = expected.lower_bound(textOf(between));
+                tree->forEachInRange(between, toKey, [&](string* key, size_t* value) {
+                    wrong += first == last || textOf(key) != first->first;
+                    if (first != last)
+                        ++first;
+                });
+                wrong += first != last;
+            }
+        }
+    }
+
+    return wrong;
+}
+
+// Trees of sizes around the capacities of one, two, three and four levels of
+// nodes, inserted in ascending, descending and random order so that nodes are
+// split at either end and in the middle, and built at once from sorted keys
+static int boundaries(size_t* numbers) {
+    static const size_t sizes[] = { 0, 1, 7, 8, 9, 16, 17, 80, 81, 89, 728, 729, 737, 6560, 6561 };
+    static const char* orders[] = { "ascending", "descending", "random" };
+    uint64_t state = 1;
+    size_t wrong = 0;
+    size_t trees = 0;
+    for (size_t s = 0; s < sizeof sizes / sizeof sizes[0]; s++) {
+        size_t size = sizes[s];
+        _Region _r; _Page* _p = _r.get();
+        std::vector<string*> sorted;
+        for (size_t i = 0; i < size; i++)
+            sorted.push_back(keyOf(_p, i));
+        std::sort(sorted.begin(), sorted.end(), [](string* a, string* b) { return textOf(a) < textOf(b); });
+
+        for (size_t o = 0; o <= 3; o++) {
+            _Region _r; _Page* _p = _r.get();
+            _Expected expected;
+            _BTreeMap<string, size_t>* tree;
+            if (o < 3) {
+                std::vector<string*> keys(sorted);
+                if (o == 1)
+                    std::reverse(keys.begin(), keys.end());
+                if (o == 2) {
+                    for (size_t i = keys.size(); i > 1; i--)
+                        std::swap(keys[i - 1], keys[nextRandom(&state) % i]);
+                }
+
+                tree = new(_p) _BTreeMap<string, size_t>();
+                for (size_t i = 0; i < keys.size(); i++) {
+                    wrong += !tree->insert(keys[i], numbers + i);
+                    expected[textOf(keys[i])] = numbers + i;
+                }
+
+                // Inserting a key again replaces its value
+                if (size) {
+                    wrong += tree->insert(keys[0], numbers + size);
+                    expected[textOf(keys[0])] = numbers + size;
+                }
+            }
+            else {
+                _Array<string>* keys = new(_p) _Array<string>();
+                _Array<size_t>* values = new(_p) _Array<size_t>();
+                for (size_t i = 0; i < size; i++) {
+                    keys->push(sorted[i]);
+                    values->push(numbers + i);
+                    expected[textOf(sorted[i])] = numbers + i;
+                }
+                tree = new(_p) _BTreeMap<string, size_t>(keys, values);
+            }
+
+            size_t treeWrong = compare(tree, expected, sorted, _p);
+            if (treeWrong)
+                printf("  %zu keys, %s: %zu wrong\n", size, o < 3 ? orders[o] : "built", treeWrong);
+            wrong += treeWrong;
+            trees++;
+        }
+    }
+
+    printf("  %zu trees compared with std::map, %zu wrong\n", trees, wrong);
+    return wrong != 0;
+}
+
+static int lookups(size_t* numbers) {
+    size_t count = 100000;
+    _Region _r; _Page* _p = _r.get();
+    _BTreeMap<string, size_t>* tree = new(_p) _BTreeMap<string, size_t>();
+    std::map<std::string, size_t*> map;
+    string** keys = (string**)_p->allocateObject(count * sizeof(string*));
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = keyOf(_p, i);
+        tree->insert(keys[i], numbers + i);
+        map[textOf(keys[i])] = numbers + i;
+    }
+
+    // The std::map is given keys it does not have to construct first
+    std::vector<std::string> texts;
+    for (size_t i = 0; i < count; i++)
+        texts.push_back(textOf(keys[i]));
+
+    size_t rounds = 1000000;
+    size_t found = 0;
+    double start = now();
+    for (size_t i = 0; i < rounds; i++)
+        found += tree->get(keys[i * 7919 % count]) != 0;
+    double treeSeconds = now() - start;
+
+    start = now();
+    for (size_t i = 0; i < rounds; i++)
+        found += map.find(texts[i * 7919 % count]) != map.end();
+    double mapSeconds = now() - start;
+
+    printf("  %zu keys: %.1f ns per lookup in the tree, %.1f ns in std::map\n", count, treeSeconds * 1e9 / rounds, mapSeconds * 1e9 / rounds);
+    return found != rounds * 2;
+}
+
+int btree() {
+    _Region _r; _Page* _p = _r.get();
+    size_t* numbers = (size_t*)_p->allocateObject(100001 * sizeof(size_t));
+    return boundaries(numbers) | lookups(numbers);
+}
+
+}
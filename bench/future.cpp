@@ -0,0 +1,76 @@
+#include "bench.h"
+using namespace scaly;
+
+namespace bench {
+
+struct _Sum {
+    size_t from;
+    size_t to;
+    pthread_t thread;
+};
+
+class _SumError {
+public:
+    _SumError(long errorCode)
+    : errorCode(errorCode) {}
+
+    long _getErrorCode() {
+        return errorCode;
+    }
+
+private:
+    long errorCode;
+};
+
+// Sums the numbers from from to to, and fails if there are none
+static _Result<size_t, _SumError> sum(_Page* _rp, _Page* _ep, _Sum* argument) {
+    argument->thread = pthread_self();
+    if (argument->from >= argument->to)
+        return _Result<size_t, _SumError>(_SumError(1));
+
+    size_t* result = (size_t*)_rp->allocateObject(sizeof(size_t));
+    *result = 0;
+    for (size_t i = argument->from; i < argument->to; i++)
+        *result += i;
+    return _Result<size_t, _SumError>(result);
+}
+
+// Twice as many futures as there are workers. The first ones get a worker each,
+// and get computes the rest in the caller's thread. Every other future fails.
+int future() {
+    size_t workers = __CurrentTask->getNumberOfWorkers();
+    size_t count = workers * 2 + 2;
+    _Region _r; _Page* _p = _r.get();
+    _Sum* sums = (_Sum*)_p->allocateObject(count * sizeof(_Sum));
+    _Future<size_t, _SumError, _Sum>** futures = (_Future<size_t, _SumError, _Sum>**)_p->allocateObject(count * sizeof(_Future<size_t, _SumError, _Sum>*));
+    for (size_t i = 0; i < count; i++) {
+        sums[i].from = i % 2 ? i : 0;
+        sums[i].to = i % 2 ? i : 100000 + i;
+        futures[i] = new(_p) _Future<size_t, _SumError, _Sum>(sum, sums + i);
+    }
+
+    size_t wrong = 0;
+    size_t onWorkers = 0;
+    size_t inCaller = 0;
+    for (size_t i = 0; i < count; i++) {
+        _Result<size_t, _SumError> result = futures[i]->get(_p, _p);
+        if (i % 2)
+            wrong += result.succeeded() || result._getErrorCode() != 1;
+        else
+            wrong += !result.succeeded() || *result.getResult() != (100000 + i) * (100000 + i - 1) / 2;
+
+        if (pthread_equal(sums[i].thread, pthread_self())) {
+            inCaller++;
+        }
+        else {
+            onWorkers++;
+            // No more futures than workers run on threads of their own
+            wrong += i >= workers;
+        }
+    }
+
+    printf("  %zu futures, %zu on workers, %zu in the caller's thread, %zu wrong\n", count, onWorkers, inCaller, wrong);
+    return wrong != 0;
+}
+
+}
@@ -0,0 +1,253 @@
+#include "bench.h"
+#include <time.h>
+#include <math.h>
+using namespace scaly;
+
+namespace bench {
+
+static double now() {
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// splitmix64, so that each run sees the same keys
+static uint64_t nextRandom(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+static void fill(char* data, size_t length, uint64_t* state) {
+    for (size_t i = 0; i < length; i++)
+        data[i] = (char)nextRandom(state);
+}
+
+// Lengths around the ends of the short forms, of a block and of several blocks
+static const size_t lengths[] = {
+    0, 1, 2, 3, 4, 7, 8, 9, 15, 16, 17, 31, 32, 33, 47, 48, 49, 63, 64, 65, 96, 100, 127, 128,
+    255, 256, 511, 512, 1000, 1023, 1024, 1025, 1087, 1088, 2047, 2048, 2049, 3000, 4096, 4097, 10000,
+};
+static const size_t numberOfLengths = sizeof lengths / sizeof lengths[0];
+
+// Each kernel which the CPU has gives the same hash as the portable one, for
+// every length and at every alignment of the data, and so does the kernel
+// which Hash::of picks
+static int kernels(char* data) {
+    static const Hash::Kernel kernels[] = { Hash::sse2Kernel, Hash::avx2Kernel };
+    static const char* names[] = { "SSE2", "AVX2" };
+    uint64_t state = 1;
+    fill(data, 10000 + 64, &state);
+
+    int failed = 0;
+    for (size_t k = 0; k <= sizeof kernels / sizeof kernels[0]; k++) {
+        bool picked = k == sizeof kernels / sizeof kernels[0];
+        if (!picked && !Hash::hasKernel(kernels[k])) {
+            printf("  %s kernel not available\n", names[k]);
+            continue;
+        }
+
+        size_t differing = 0;
+        for (size_t i = 0; i < numberOfLengths; i++) {
+            for (size_t offset = 0; offset < 64; offset += 9) {
+                size_t expected = Hash::of(data + offset, lengths[i], Hash::portableKernel);
+                size_t hash = picked ? Hash::of(data + offset, lengths[i]) : Hash::of(data + offset, lengths[i], kernels[k]);
+                differing += hash != expected;
+            }
+        }
+        printf("  %s kernel: %zu hashes differ from the portable one\n", picked ? "picked" : names[k], differing);
+        failed |= differing != 0;
+    }
+
+    return failed;
+}
+
+// Hasher gives the same hash as Hash::of however the bytes are cut into pieces
+static int streaming(char* data) {
+    static const size_t pieces[] = { 1, 3, 16, 63, 64, 1023, 1024, 1025, 3000 };
+    uint64_t state = 2;
+    fill(data, 10000, &state);
+
+    size_t differing = 0;
+    size_t checked = 0;
+    for (size_t i = 0; i < numberOfLengths; i++) {
+        size_t length = lengths[i];
+        size_t expected = Hash::of(data, length);
+        for (size_t p = 0; p <= sizeof pieces / sizeof pieces[0]; p++) {
+            _Region _r; _Page* _p = _r.get();
+            Hasher* hasher = new(_p) Hasher();
+            for (size_t done = 0; done < length;) {
+                // After the fixed sizes, pieces of random sizes
+                size_t piece = p < sizeof pieces / sizeof pieces[0] ? pieces[p] : 1 + nextRandom(&state) % 1500;
+                if (piece > length - done)
+                    piece = length - done;
+                hasher->append(data + done, piece);
+                done += piece;
+            }
+            differing += hasher->finish() != expected;
+            checked++;
+
+            // finish may be followed by more bytes
+            if (length) {
+                Hasher* split = new(_p) Hasher();
+                split->append(data, length / 2);
+                split->finish();
+                split->append(data + length / 2, length - length / 2);
+                differing += split->finish() != expected;
+                checked++;
+            }
+        }
+    }
+
+    printf("  %zu of %zu streamed hashes differ from the one-shot ones\n", differing, checked);
+    return differing != 0;
+}
+
+// Flipping one input bit flips each output bit with a chance of one half. For
+// each length, the worst cell of the input by output bit table may stray from
+// one half by no more than chance allows.
+static int avalanche(char* data) {
+    static const size_t avalancheLengths[] = { 3, 4, 8, 16, 17, 32, 64, 128, 1100 };
+    uint64_t state = 3;
+    int failed = 0;
+    for (size_t l = 0; l < sizeof avalancheLengths / sizeof avalancheLengths[0]; l++) {
+        size_t length = avalancheLengths[l];
+        size_t bits = length * 8;
+        size_t keys = length > 128 ? 100 : 2000;
+
+        _Region _r; _Page* _p = _r.get();
+        uint32_t* flips = (uint32_t*)_p->allocateObject(bits * 64 * sizeof(uint32_t));
+        memset(flips, 0, bits * 64 * sizeof(uint32_t));
+        for (size_t k = 0; k < keys; k++) {
+            fill(data, length, &state);
+            uint64_t hash = Hash::of(data, length);
+            for (size_t bit = 0; bit < bits; bit++) {
+                data[bit / 8] ^= 1 << (bit % 8);
+                uint64_t flipped = hash ^ Hash::of(data, length);
+                data[bit / 8] ^= 1 << (bit % 8);
+                for (size_t out = 0; out < 64; out++)
+                    flips[bit * 64 + out] += (flipped >> out) & 1;
+            }
+        }
+
+        double worst = 0;
+        for (size_t i = 0; i < bits * 64; i++) {
+            double bias = flips[i] / (double)keys - 0.5;
+            if (bias < 0)
+                bias = -bias;
+            if (bias > worst)
+                worst = bias;
+        }
+
+        // Seven standard deviations of a fair coin over keys throws
+        double allowed = 7 * 0.5 / sqrt((double)keys);
+        printf("  %zu bytes, %zu keys: worst bias %.3f, allowed %.3f\n", length, keys, worst, allowed);
+        failed |= worst > allowed;
+    }
+    return failed;
+}
+
+// The collisions among count hashes, in all 64 bits and in the low 32 bits
+// which a hash table of up to 2^32 slots would use
+static int collisions(const char* name, uint64_t* hashes, size_t count) {
+    Sort::radixSort(hashes, count, [](uint64_t hash) { return hash; });
+    size_t full = 0;
+    for (size_t i = 1; i < count; i++)
+        full += hashes[i] == hashes[i - 1];
+
+    for (size_t i = 0; i < count; i++)
+        hashes[i] &= 0xffffffff;
+    Sort::radixSort(hashes, count, [](uint64_t hash) { return hash; });
+    size_t low = 0;
+    for (size_t i = 1; i < count; i++)
+        low += hashes[i] == hashes[i - 1];
+
+    // The number of pairs over the number of values, plus ample room for chance
+    double expected = (double)count * (count - 1) / 2 / 4294967296.0;
+    double allowed = expected + 6 * sqrt(expected) + 2;
+    printf("  %s: %zu keys, %zu collisions, %zu in the low 32 bits where %.1f are expected\n", name, count, full, low, expected);
+    return full != 0 || low > allowed;
+}
+
+// Sets of keys which differ only a little: few bits set, identifiers with a
+// counter, repeated patterns and runs of zeroes which differ only in length
+static int collisionSets(char* data) {
+    _Region _r; _Page* _p = _r.get();
+    uint64_t* hashes = (uint64_t*)_p->allocateObject(200000 * sizeof(uint64_t));
+    int failed = 0;
+
+    // 256 bit keys with up to two bits set
+    size_t count = 0;
+    memset(data, 0, 32);
+    hashes[count++] = Hash::of(data, 32);
+    for (size_t i = 0; i < 256; i++) {
+        data[i / 8] ^= 1 << (i % 8);
+        hashes[count++] = Hash::of(data, 32);
+        for (size_t j = i + 1; j < 256; j++) {
+            data[j / 8] ^= 1 << (j % 8);
+            hashes[count++] = Hash::of(data, 32);
+            data[j / 8] ^= 1 << (j % 8);
+        }
+        data[i / 8] ^= 1 << (i % 8);
+    }
+    failed |= collisions("sparse", hashes, count);
+
+    // Names like a program has
+    count = 0;
+    for (size_t i = 0; i < 200000; i++) {
+        int length = snprintf(data, 64, "identifier%zu", i);
+        hashes[count++] = Hash::of(data, length);
+    }
+    failed |= collisions("text", hashes, count);
+
+    // Eight random bytes repeated to 64 and to 2000 bytes
+    uint64_t state = 4;
+    const size_t cyclicLengths[] = { 64, 2000 };
+    for (size_t c = 0; c < 2; c++) {
+        count = 0;
+        for (size_t i = 0; i < 50000; i++) {
+            fill(data, 8, &state);
+            for (size_t j = 8; j < cyclicLengths[c]; j++)
+                data[j] = data[j - 8];
+            hashes[count++] = Hash::of(data, cyclicLengths[c]);
+        }
+        failed |= collisions(c ? "cyclic, 2000 bytes" : "cyclic, 64 bytes", hashes, count);
+    }
+
+    // Zeroes of every length up to 10000
+    memset(data, 0, 10000);
+    count = 0;
+    for (size_t length = 0; length <= 10000; length++)
+        hashes[count++] = Hash::of(data, length);
+    failed |= collisions("zeroes", hashes, count);
+
+    return failed;
+}
+
+static int throughput(char* data) {
+    uint64_t state = 5;
+    fill(data, 10000, &state);
+    const size_t measuredLengths[] = { 16, 100, 10000 };
+    size_t sum = 0;
+    for (size_t l = 0; l < 3; l++) {
+        size_t length = measuredLengths[l];
+        size_t rounds = 20000000 / (length + 16);
+        double start = now();
+        for (size_t i = 0; i < rounds; i++)
+            sum += Hash::of(data, length);
+        double seconds = now() - start;
+        printf("  %zu bytes: %.1f ns per hash, %.2f GB/s\n", length, seconds * 1e9 / rounds, rounds * length / seconds * 1e-9);
+    }
+
+    // Keeps the hashing from being optimized away
+    return sum == 1;
+}
+
+int hash() {
+    _Region _r; _Page* _p = _r.get();
+    char* data = (char*)_p->allocateObject(10000 + 64);
+    return kernels(data) | streaming(data) | avalanche(data) | collisionSets(data) | throughput(data);
+}
+
+}
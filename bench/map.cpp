@@ -0,0 +1,84 @@
+#include "bench.h"
+#include <time.h>
+using namespace scaly;
+
+namespace bench {
+
+static double now() {
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// What a map would be without hashing: keys and values side by side
+static size_t* scan(_Array<string>* keys, _Array<size_t>* values, string* key) {
+    size_t length = keys->length();
+    for (size_t i = 0; i < length; i++) {
+        if ((*(*keys)[i])->equals(key))
+            return *(*values)[i];
+    }
+    return 0;
+}
+
+// The same entries in a hash map and in arrays. Every key is looked up as a
+// string of its own, so that no lookup finds its key by identity.
+static int entries(size_t count) {
+    _Region _r; _Page* _p = _r.get();
+    size_t* numbers = (size_t*)_p->allocateObject(count * sizeof(size_t));
+    string** hits = (string**)_p->allocateObject(count * sizeof(string*));
+    string** misses = (string**)_p->allocateObject(count * sizeof(string*));
+    _HashMap<string, size_t>* map = new(_p) _HashMap<string, size_t>();
+    _Array<string>* keys = new(_p) _Array<string>();
+    _Array<size_t>* values = new(_p) _Array<size_t>();
+    char name[32];
+    size_t wrong = 0;
+    for (size_t i = 0; i < count; i++) {
+        numbers[i] = i;
+        snprintf(name, sizeof name, "identifier%zu", i);
+        string* key = new(_p) string(name);
+        wrong += !map->insert(key, numbers + i);
+        keys->push(key);
+        values->push(numbers + i);
+        hits[i] = new(_p) string(name);
+        snprintf(name, sizeof name, "identifier%zu", count + i);
+        misses[i] = new(_p) string(name);
+    }
+
+    // Inserting a key again replaces its value
+    wrong += map->insert(hits[0], numbers + count - 1) || map->get(hits[0]) != numbers + count - 1;
+    map->insert(hits[0], numbers);
+    wrong += map->length() != count;
+
+    for (size_t i = 0; i < count; i++) {
+        wrong += map->get(hits[i]) != numbers + i || map->get(misses[i]) != 0;
+        wrong += !map->contains(hits[i]) || map->contains(misses[i]);
+    }
+
+    // The scan takes count steps for each lookup, so it gets fewer of them
+    size_t mapLookups = 2000000;
+    size_t scanLookups = 20000000 / count;
+    if (scanLookups > mapLookups)
+        scanLookups = mapLookups;
+
+    // Striding by a prime spreads even a few lookups over all the keys
+    size_t found = 0;
+    double start = now();
+    for (size_t i = 0; i < mapLookups; i++)
+        found += map->get(hits[i * 7919 % count]) != 0;
+    double mapSeconds = now() - start;
+
+    start = now();
+    for (size_t i = 0; i < scanLookups; i++)
+        found += scan(keys, values, hits[i * 7919 % count]) != 0;
+    double scanSeconds = now() - start;
+
+    wrong += found != mapLookups + scanLookups;
+    printf("  %zu entries: %.1f ns per lookup in the map, %.1f ns in the array, %zu wrong\n", count, mapSeconds * 1e9 / mapLookups, scanSeconds * 1e9 / scanLookups, wrong);
+    return wrong != 0;
+}
+
+int map() {
+    return entries(10) | entries(1000) | entries(100000);
+}
+
+}
@@ -0,0 +1,151 @@
+#include "bench.h"
+#include <map>
+#include <vector>
+#include <string>
+using namespace scaly;
+
+namespace bench {
+
+// splitmix64, so that each run makes the same changes
+static uint64_t nextRandom(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+// Every version is compared with the std::vector it should hold, and every
+// 37th one is kept with a copy of that to be compared again in the end, when
+// all later versions have been made from it or from its successors
+static int vector(size_t* numbers, size_t count) {
+    _Region _r; _Page* _p = _r.get();
+    std::vector<size_t> expected;
+    std::vector<std::pair<_PersistentVector<size_t>*, std::vector<size_t> > > kept;
+    _PersistentVector<size_t>* version = new(_p) _PersistentVector<size_t>();
+    uint64_t state = 1;
+    size_t wrong = 0;
+    size_t changes = count * 3 / 2;
+    for (size_t change = 0; change < changes; change++) {
+        if (change < count) {
+            version = version->push(_p, numbers + change);
+            expected.push_back(change);
+        }
+        else {
+            // Items in the tail and deep in the trie are replaced alike
+            size_t i = nextRandom(&state) % count;
+            size_t value = count + change;
+            version = version->set(_p, i, numbers + value);
+            expected[i] = value;
+        }
+
+        wrong += version->length() != expected.size();
+        if (change % 37 == 0 || change + 1 == count) {
+            for (size_t i = 0; i < expected.size(); i++)
+                wrong += version->get(i) != numbers + expected[i];
+            kept.push_back(std::make_pair(version, expected));
+        }
+    }
+
+    for (size_t k = 0; k < kept.size(); k++) {
+        _PersistentVector<size_t>* old = kept[k].first;
+        std::vector<size_t>& items = kept[k].second;
+        wrong += old->length() != items.size() || old->get(items.size()) != 0;
+        for (size_t i = 0; i < items.size(); i++)
+            wrong += old->get(i) != numbers + items[i];
+    }
+
+    printf("  vector: %zu changes, %zu old versions checked, %zu wrong\n", changes, kept.size(), wrong);
+    return wrong != 0;
+}
+
+// A key whose hash has few values, so that many keys share all bits of it
+// and the map has to keep them in collision nodes
+class _CrowdedKey {
+public:
+    _CrowdedKey(string* name)
+    : name(name) {}
+
+    char* getNativeString() {
+        return name->getNativeString();
+    }
+
+    size_t getLength() {
+        return name->getLength();
+    }
+
+    size_t getHash() {
+        return name->getHash() % 61;
+    }
+
+private:
+    string* name;
+};
+
+// Makes a version for each insertion, replacement and removal, and compares
+// the versions like vector does with a std::map
+template<class K> static int hashMap(const char* name, K** keys, size_t* numbers, size_t count) {
+    _Region _r; _Page* _p = _r.get();
+    std::map<size_t, size_t> expected;
+    std::vector<std::pair<_PersistentHashMap<K, size_t>*, std::map<size_t, size_t> > > kept;
+    _PersistentHashMap<K, size_t>* version = new(_p) _PersistentHashMap<K, size_t>();
+    uint64_t state = 2;
+    size_t wrong = 0;
+    size_t changes = count * 2;
+    for (size_t change = 0; change < changes; change++) {
+        size_t key = change < count ? change : nextRandom(&state) % count;
+        if (change < count || change % 2) {
+            // Inserts the keys, then replaces the values of some
+            size_t value = count + change;
+            version = version->insert(_p, keys[key], numbers + value);
+            expected[key] = value;
+        }
+        else {
+            _PersistentHashMap<K, size_t>* removed = version->remove(_p, keys[key]);
+            wrong += (removed == version) != !expected.count(key);
+            version = removed;
+            expected.erase(key);
+        }
+
+        wrong += version->length() != expected.size();
+        if (change % 37 == 0 || change + 1 == count)
+            kept.push_back(std::make_pair(version, expected));
+    }
+
+    for (size_t k = 0; k < kept.size(); k++) {
+        _PersistentHashMap<K, size_t>* old = kept[k].first;
+        std::map<size_t, size_t>& entries = kept[k].second;
+        wrong += old->length() != entries.size();
+        for (size_t key = 0; key < count; key++) {
+            std::map<size_t, size_t>::iterator entry = entries.find(key);
+            size_t* value = old->get(keys[key]);
+            wrong += entry == entries.end() ? value != 0 : value != numbers + entry->second;
+            wrong += old->contains(keys[key]) != (entry != entries.end());
+        }
+    }
+
+    printf("  %s: %zu changes, %zu old versions checked, %zu wrong\n", name, changes, kept.size(), wrong);
+    return wrong != 0;
+}
+
+int persistent() {
+    // A tail and two levels of the trie are filled, and a third is begun
+    size_t count = 1100;
+    _Region _r; _Page* _p = _r.get();
+    size_t* numbers = (size_t*)_p->allocateObject(count * 3 * sizeof(size_t));
+    string** keys = (string**)_p->allocateObject(count * sizeof(string*));
+    _CrowdedKey** crowdedKeys = (_CrowdedKey**)_p->allocateObject(count * sizeof(_CrowdedKey*));
+    char name[32];
+    for (size_t i = 0; i < count * 3; i++)
+        numbers[i] = i;
+    for (size_t i = 0; i < count; i++) {
+        snprintf(name, sizeof name, "key%zu", i);
+        keys[i] = new(_p) string(name);
+        crowdedKeys[i] = new(_p->allocateObject(sizeof(_CrowdedKey))) _CrowdedKey(keys[i]);
+    }
+
+    return vector(numbers, count)
+        | hashMap("hash map", keys, numbers, count)
+        | hashMap("hash map with colliding hashes", crowdedKeys, numbers, count);
+}
+
+}
@@ -0,0 +1,98 @@
+#include "bench.h"
+#include <time.h>
+using namespace scaly;
+namespace scaly {
+
+extern __thread _Page* __CurrentPage;
+extern __thread _Task* __CurrentTask;
+
+}
+
+namespace bench {
+
+static double now() {
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// The main thread fills its root page bit by bit until it has taken more pages
+// than a chunk has. So whenever the pool needs another chunk, the root page is
+// full. The pool used to push the new chunk onto a list on the root page with
+// its mutex held, which deadlocked when the list needed an extension page.
+static int moreThanAChunk() {
+    while (__CurrentTask->getPagesAllocated() <= _Chunk::numberOfPages)
+        __CurrentPage->allocateObject(_alignment);
+
+    printf("  %zu pages from the main thread, %zu pool accesses\n", __CurrentTask->getPagesAllocated(), __CurrentTask->getPoolAccesses());
+    return 0;
+}
+
+struct _Worker {
+    _Task* task;
+    pthread_t thread;
+    size_t rounds;
+    size_t poolAccesses;
+    size_t pagesAllocated;
+};
+
+static void* contend(void* argument) {
+    _Worker* worker = (_Worker*)argument;
+    _Page* rootPage = _Task::enterThread(worker->task);
+    if (!rootPage)
+        return 0;
+
+    // Up to half a magazine of pages in flight, as a region which grows and shrinks
+    _Page* pages[_Task::magazineSize / 2];
+    for (size_t round = 0; round < worker->rounds; round++) {
+        for (size_t i = 0; i < _Task::magazineSize / 2; i++) {
+            pages[i] = __CurrentTask->getExtensionPage();
+            pages[i]->reset();
+        }
+        for (size_t i = 0; i < _Task::magazineSize / 2; i++)
+            __CurrentTask->releaseExtensionPage(pages[i]);
+    }
+
+    worker->poolAccesses = __CurrentTask->getPoolAccesses();
+    worker->pagesAllocated = __CurrentTask->getPagesAllocated();
+    _Task::leaveThread(rootPage);
+    return 0;
+}
+
+// Workers which allocate and release pages at the same time. Only refilling and
+// flushing a magazine go to the shared pool, so a worker whose pages stay within
+// its magazine touches nothing but its own task: it accesses the pool once.
+static int contention() {
+    size_t workers = __CurrentTask->getNumberOfWorkers();
+    if (workers < 8)
+        workers = 8;
+
+    _Region _region; _Page* _p = _region.get();
+    _Worker* worker = (_Worker*)_p->allocateObject(workers * sizeof(_Worker));
+    double start = now();
+    for (size_t i = 0; i < workers; i++) {
+        worker[i].task = __CurrentTask;
+        worker[i].rounds = 40000;
+        worker[i].poolAccesses = 0;
+        worker[i].pagesAllocated = 0;
+        pthread_create(&worker[i].thread, 0, contend, worker + i);
+    }
+
+    size_t pagesAllocated = 0;
+    size_t poolAccesses = 0;
+    for (size_t i = 0; i < workers; i++) {
+        pthread_join(worker[i].thread, 0);
+        pagesAllocated += worker[i].pagesAllocated;
+        poolAccesses += worker[i].poolAccesses;
+    }
+    double seconds = now() - start;
+
+    printf("  %zu workers, %zu pages, %zu pool accesses, %.1f ns per page\n", workers, pagesAllocated, poolAccesses, seconds * 1e9 / pagesAllocated);
+    return poolAccesses > workers;
+}
+
+int pool() {
+    return moreThanAChunk() | contention();
+}
+
+}
@@ -0,0 +1,188 @@
+#include "bench.h"
+#include <time.h>
+#include <sched.h>
+using namespace scaly;
+
+namespace bench {
+
+static double now() {
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// The items are pointers to their own numbers, and each one which arrives is
+// counted in seen, which has to be 1 for all of them in the end
+template<class Q> struct _Run {
+    Q* queue;
+    size_t* items;
+    std::atomic<size_t>* seen;
+    size_t count;
+    std::atomic<size_t> received;
+};
+
+template<class Q> struct _Producer {
+    _Run<Q>* run;
+    size_t from;
+    size_t to;
+    pthread_t thread;
+};
+
+static void receive(std::atomic<size_t>* seen, std::atomic<size_t>* received, size_t* item) {
+    seen[*item].fetch_add(1, std::memory_order_relaxed);
+    received->fetch_add(1, std::memory_order_relaxed);
+}
+
+template<class Q> static void* produce(void* argument) {
+    _Producer<Q>* producer = (_Producer<Q>*)argument;
+    for (size_t i = producer->from; i < producer->to; i++) {
+        while (!producer->run->queue->push(producer->run->items + i))
+            sched_yield();
+    }
+    return 0;
+}
+
+template<class Q> static void* consume(void* argument) {
+    _Run<Q>* run = (_Run<Q>*)argument;
+    while (run->received.load(std::memory_order_relaxed) < run->count) {
+        size_t* item = run->queue->pop();
+        if (item)
+            receive(run->seen, &run->received, item);
+        else
+            sched_yield();
+    }
+    return 0;
+}
+
+static size_t* numbers(_Page* _p, size_t count) {
+    size_t* items = (size_t*)_p->allocateObject(count * sizeof(size_t));
+    for (size_t i = 0; i < count; i++)
+        items[i] = i;
+    return items;
+}
+
+static std::atomic<size_t>* counters(_Page* _p, size_t count) {
+    std::atomic<size_t>* seen = (std::atomic<size_t>*)_p->allocateObject(count * sizeof(std::atomic<size_t>));
+    for (size_t i = 0; i < count; i++)
+        new(seen + i) std::atomic<size_t>(0);
+    return seen;
+}
+
+// The items which did not arrive exactly once
+static size_t lost(std::atomic<size_t>* seen, size_t count) {
+    size_t wrong = 0;
+    for (size_t i = 0; i < count; i++)
+        wrong += seen[i].load(std::memory_order_relaxed) != 1;
+    return wrong;
+}
+
+// Producers and consumers of a ring buffer, each on a thread of its own
+template<class Q> static int transfer(const char* name, Q* queue, size_t producers, size_t consumers, size_t count) {
+    _Region _r; _Page* _p = _r.get();
+    _Run<Q> run;
+    run.queue = queue;
+    run.items = numbers(_p, count);
+    run.seen = counters(_p, count);
+    run.count = count;
+    run.received.store(0, std::memory_order_relaxed);
+
+    _Producer<Q>* producer = (_Producer<Q>*)_p->allocateObject(producers * sizeof(_Producer<Q>));
+    pthread_t* consumer = (pthread_t*)_p->allocateObject(consumers * sizeof(pthread_t));
+    double start = now();
+    for (size_t i = 0; i < producers; i++) {
+        producer[i].run = &run;
+        producer[i].from = count * i / producers;
+        producer[i].to = count * (i + 1) / producers;
+        pthread_create(&producer[i].thread, 0, produce<Q>, producer + i);
+    }
+    for (size_t i = 0; i < consumers; i++)
+        pthread_create(consumer + i, 0, consume<Q>, &run);
+    for (size_t i = 0; i < producers; i++)
+        pthread_join(producer[i].thread, 0);
+    for (size_t i = 0; i < consumers; i++)
+        pthread_join(consumer[i], 0);
+    double seconds = now() - start;
+
+    size_t wrong = lost(run.seen, count);
+    printf("  %s, %zu to %zu: %.1f M items/s, %zu of %zu items not received exactly once\n", name, producers, consumers, count / seconds * 1e-6, wrong, count);
+    return wrong != 0 || queue->pop() != 0;
+}
+
+struct _Thief {
+    _Run<_Deque<size_t> >* run;
+    size_t stolen;
+    pthread_t thread;
+};
+
+static void* steal(void* argument) {
+    _Thief* thief = (_Thief*)argument;
+    _Run<_Deque<size_t> >* run = thief->run;
+    while (run->received.load(std::memory_order_relaxed) < run->count) {
+        size_t* item = run->queue->steal();
+        if (item) {
+            receive(run->seen, &run->received, item);
+            thief->stolen++;
+        }
+        else {
+            sched_yield();
+        }
+    }
+    return 0;
+}
+
+// The owner pushes, growing the deque from a few slots, and pops every third
+// item back, down to the last one, which the thieves may be taking as well
+static int workStealing(size_t thieves, size_t count) {
+    _Region _r; _Page* _p = _r.get();
+    _Run<_Deque<size_t> > run;
+    run.queue = new(_p) _Deque<size_t>(4);
+    run.items = numbers(_p, count);
+    run.seen = counters(_p, count);
+    run.count = count;
+    run.received.store(0, std::memory_order_relaxed);
+
+    _Thief* thief = (_Thief*)_p->allocateObject(thieves * sizeof(_Thief));
+    double start = now();
+    for (size_t i = 0; i < thieves; i++) {
+        thief[i].run = &run;
+        thief[i].stolen = 0;
+        pthread_create(&thief[i].thread, 0, steal, thief + i);
+    }
+
+    size_t popped = 0;
+    for (size_t i = 0; i < count; i++) {
+        run.queue->push(run.items + i);
+        if (i % 3 == 2) {
+            size_t* item = run.queue->pop();
+            if (item) {
+                receive(run.seen, &run.received, item);
+                popped++;
+            }
+        }
+    }
+    while (size_t* item = run.queue->pop()) {
+        receive(run.seen, &run.received, item);
+        popped++;
+    }
+
+    size_t stolen = 0;
+    for (size_t i = 0; i < thieves; i++) {
+        pthread_join(thief[i].thread, 0);
+        stolen += thief[i].stolen;
+    }
+    double seconds = now() - start;
+
+    size_t wrong = lost(run.seen, count);
+    printf("  deque, %zu thieves: %.1f M items/s, %zu popped, %zu stolen, %zu of %zu items not received exactly once\n", thieves, count / seconds * 1e-6, popped, stolen, wrong, count);
+    return wrong != 0 || run.queue->length() != 0;
+}
+
+int queue() {
+    _Region _r; _Page* _p = _r.get();
+    return transfer("ring buffer", new(_p) _RingBuffer<size_t>(1024), 1, 1, 2000000)
+        | transfer("concurrent ring buffer", new(_p) _ConcurrentRingBuffer<size_t>(1024), 4, 1, 1000000)
+        | transfer("concurrent ring buffer", new(_p) _ConcurrentRingBuffer<size_t>(1024), 4, 4, 1000000)
+        | workStealing(3, 1000000);
+}
+
+}
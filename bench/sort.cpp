@@ -0,0 +1,112 @@
+#include "bench.h"
+#include <time.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+using namespace scaly;
+
+namespace bench {
+
+static double now() {
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// splitmix64, so that each run sorts the same items
+static uint64_t nextRandom(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+// An item remembers where it was, so that a sort which swaps equal keys shows
+struct _Item {
+    uint32_t key;
+    uint32_t position;
+};
+
+static size_t differences(_Item* items, std::vector<_Item>& expected) {
+    size_t wrong = 0;
+    for (size_t i = 0; i < expected.size(); i++)
+        wrong += items[i].key != expected[i].key || items[i].position != expected[i].position;
+    return wrong;
+}
+
+// Sorts the same items with std::stable_sort, mergeSort and radixSort, which
+// all have to leave them in the same order. Few distinct keys make many ties.
+static int numberKeys(size_t length, uint32_t distinct, uint64_t seed) {
+    _Region _r; _Page* _p = _r.get();
+    _Item* items = (_Item*)_p->allocateObject(length * sizeof(_Item));
+    std::vector<_Item> original(length);
+    uint64_t state = seed;
+    for (size_t i = 0; i < length; i++) {
+        original[i].key = distinct ? nextRandom(&state) % distinct : (uint32_t)nextRandom(&state);
+        original[i].position = i;
+    }
+
+    std::vector<_Item> expected(original);
+    double start = now();
+    std::stable_sort(expected.begin(), expected.end(), [](const _Item& a, const _Item& b) { return a.key < b.key; });
+    double stableSeconds = now() - start;
+
+    std::copy(original.begin(), original.end(), items);
+    start = now();
+    Sort::mergeSort(items, length, [](const _Item& a, const _Item& b) { return a.key < b.key; });
+    double mergeSeconds = now() - start;
+    size_t mergeWrong = differences(items, expected);
+
+    std::copy(original.begin(), original.end(), items);
+    start = now();
+    Sort::radixSort(items, length, [](const _Item& item) { return item.key; });
+    double radixSeconds = now() - start;
+    size_t radixWrong = differences(items, expected);
+
+    printf("  %zu items, %s%s keys: std::stable_sort %.1f ms, mergeSort %.1f ms with %zu misplaced, radixSort %.1f ms with %zu misplaced\n",
+        length, distinct ? std::to_string(distinct).c_str() : "random", distinct ? " distinct" : "", stableSeconds * 1e3, mergeSeconds * 1e3, mergeWrong, radixSeconds * 1e3, radixWrong);
+    return mergeWrong != 0 || radixWrong != 0;
+}
+
+static std::string textOf(string* s) {
+    return std::string(s->getNativeString(), s->getLength());
+}
+
+// Strings which tie in full, on their first eight bytes and up to the end of
+// the shorter one, sorted in an _Array. Equal strings are different objects,
+// so a sort which swaps them shows.
+static int stringKeys(size_t length) {
+    static const char* texts[] = { "", "a", "ab", "identifi", "identifier", "identifier1", "identifier2", "x", "x1" };
+    static const size_t numberOfTexts = sizeof texts / sizeof texts[0];
+    _Region _r; _Page* _p = _r.get();
+    _Array<string>* array = new(_p) _Array<string>();
+    uint64_t state = 3;
+    for (size_t i = 0; i < length; i++)
+        array->push(new(_p) string(texts[nextRandom(&state) % numberOfTexts]));
+
+    std::vector<string*> expected(array->getRawArray(), array->getRawArray() + length);
+    std::stable_sort(expected.begin(), expected.end(), [](string* a, string* b) { return textOf(a) < textOf(b); });
+
+    _Array<string>* copy = new(_p) _Array<string>(array);
+    Sort::radixSortByString(copy, [](string* s) { return s; });
+    size_t wrong = 0;
+    for (size_t i = 0; i < length; i++)
+        wrong += *(*copy)[i] != expected[i];
+
+    copy = new(_p) _Array<string>(array);
+    Sort::mergeSort(copy, [](string* a, string* b) { return textOf(a) < textOf(b); });
+    for (size_t i = 0; i < length; i++)
+        wrong += *(*copy)[i] != expected[i];
+
+    printf("  %zu strings: %zu misplaced by radixSortByString and mergeSort\n", length, wrong);
+    return wrong != 0;
+}
+
+// Lengths on either side of where the sorts go to worker threads
+int sort() {
+    return numberKeys(1000, 16, 1) | numberKeys(1000, 0, 2)
+        | numberKeys(Sort::minimumPart * 4 + 1, 16, 3) | numberKeys(Sort::minimumPart * 4 + 1, 0, 4)
+        | stringKeys(1000) | stringKeys(Sort::minimumPart * 2 + 3);
+}
+
+}
@@ -0,0 +1,105 @@
+#include "bench.h"
+#include <time.h>
+using namespace scaly;
+
+namespace bench {
+
+static double now() {
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// Up to 23 bytes a string keeps its chars within itself, beyond that in a buffer
+static const size_t lengths[] = { 0, 1, 8, 23, 24, 100, 1000 };
+static const size_t numberOfLengths = sizeof lengths / sizeof lengths[0];
+
+static bool isInline(string* s) {
+    char* chars = s->getNativeString();
+    return chars >= (char*)s && chars < (char*)(s + 1);
+}
+
+// Strings of each length, equal ones and ones differing in their last byte,
+// compare and hash as their bytes do
+static int checks(char* data) {
+    size_t wrong = 0;
+    for (size_t l = 0; l < numberOfLengths; l++) {
+        size_t length = lengths[l];
+        _Region _r; _Page* _p = _r.get();
+        string* s = new(_p) string(data, length);
+        string* same = new(_p) string(data, length);
+        wrong += isInline(s) != (length <= 23);
+        wrong += s->getLength() != length || memcmp(s->getNativeString(), data, length) || s->getNativeString()[length];
+        wrong += !s->equals(same) || !s->equals(s) || s->notEquals(same);
+        wrong += s->getHash() != Hash::of(data, length) || s->getHash() != same->getHash();
+
+        // A copy takes over the hash, which must still be the right one
+        string* copy = new(_p) string(s);
+        wrong += !copy->equals(s) || copy->getHash() != s->getHash();
+
+        if (length) {
+            data[length - 1]++;
+            string* other = new(_p) string(data, length);
+            data[length - 1]--;
+            wrong += s->equals(other) || other->equals(s);
+            wrong += other->getHash() == s->getHash();
+
+            // Once both hashes are known, they rule out the bytes
+            other->getHash();
+            wrong += s->equals(other);
+
+            string* shorter = new(_p) string(data, length - 1);
+            wrong += s->equals(shorter) || shorter->equals(s);
+        }
+    }
+
+    printf("  %zu lengths checked, %zu wrong\n", numberOfLengths, wrong);
+    return wrong != 0;
+}
+
+static int throughput(char* data) {
+    size_t sum = 0;
+    for (size_t l = 0; l < numberOfLengths; l++) {
+        size_t length = lengths[l];
+        size_t rounds = (8000 / (length + 16) + 1) * 1000;
+
+        // Constructed in batches, so that the region stays small
+        double start = now();
+        for (size_t done = 0; done < rounds; done += 1000) {
+            _Region _r; _Page* _p = _r.get();
+            for (size_t i = 0; i < 1000; i++)
+                sum += new(_p) string(data, length) != 0;
+        }
+        double constructing = now() - start;
+
+        _Region _r; _Page* _p = _r.get();
+        string* s = new(_p) string(data, length);
+        string* same = new(_p) string(data, length);
+        start = now();
+        for (size_t i = 0; i < rounds; i++)
+            sum += s->equals(same);
+        double comparing = now() - start;
+
+        // A long string keeps its hash, a short one is hashed each time
+        start = now();
+        for (size_t i = 0; i < rounds; i++)
+            sum += s->getHash();
+        double hashing = now() - start;
+
+        printf("  %zu bytes: %.1f ns to construct, %.1f ns to compare, %.1f ns to hash\n", length,
+            constructing * 1e9 / rounds, comparing * 1e9 / rounds, hashing * 1e9 / rounds);
+    }
+
+    // Keeps the work from being optimized away
+    return sum == 1;
+}
+
+int strings() {
+    _Region _r; _Page* _p = _r.get();
+    char* data = (char*)_p->allocateObject(1000);
+    for (size_t i = 0; i < 1000; i++)
+        data[i] = 'a' + i % 26;
+    return checks(data) | throughput(data);
+}
+
+}
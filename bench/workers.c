@@ -0,0 +1,75 @@
+#include "../scaly/scaly.h"
+
+extern _Thread_local scaly_Page* __CurrentPage;
+extern _Thread_local scaly_Task* __CurrentTask;
+
+enum { workers = 8, rounds = 20000 };
+
+typedef struct bench_Work bench_Work;
+struct bench_Work {
+    int number;
+    size_t pagesAllocated;
+};
+
+// Takes and gives back pages while the other workers do, then fills the root
+// page beyond a chunk, so that the shared pool grows from a worker thread.
+// Returns the number of the worker, which join has to hand back.
+static int bench_work(void* argument) {
+    bench_Work* work = (bench_Work*)argument;
+    scaly_Page* pages[scaly_Task_magazineSize / 2];
+    for (size_t round = 0; round < rounds; round++) {
+        for (size_t i = 0; i < scaly_Task_magazineSize / 2; i++) {
+            pages[i] = scaly_Task_getExtensionPage(__CurrentTask);
+            if (!pages[i])
+                return -1;
+            scaly_Page_reset(pages[i]);
+        }
+        for (size_t i = 0; i < scaly_Task_magazineSize / 2; i++)
+            scaly_Task_releaseExtensionPage(__CurrentTask, pages[i]);
+    }
+
+    size_t start = __CurrentTask->pagesAllocated;
+    while (__CurrentTask->pagesAllocated - start <= scaly_numberOfPages)
+        scaly_Page_allocateObject(__CurrentPage, scaly_alignment);
+
+    work->pagesAllocated = __CurrentTask->pagesAllocated;
+    return work->number;
+}
+
+// Workers of the C runtime, spawned and joined with their results
+int bench_workers() {
+    // The C runtime keeps its own root page and task
+    scaly_Page* rootPage = 0;
+    posix_memalign((void**)&rootPage, scaly_pageSize, scaly_pageSize * scaly_maxStackPages);
+    if (!rootPage)
+        return 1;
+    scaly_Page_reset(rootPage);
+    __CurrentPage = rootPage;
+    __CurrentTask = scaly_Task_new(rootPage);
+
+    bench_Work work[workers];
+    scaly_Worker* worker[workers];
+    int failed = 0;
+    for (int i = 0; i < workers; i++) {
+        work[i].number = i;
+        work[i].pagesAllocated = 0;
+        worker[i] = scaly_Task_spawn(rootPage, bench_work, work + i);
+        failed |= !worker[i];
+    }
+
+    size_t pagesAllocated = 0;
+    for (int i = 0; i < workers; i++) {
+        if (!worker[i])
+            continue;
+        failed |= scaly_Task_join(worker[i]) != i;
+        pagesAllocated += work[i].pagesAllocated;
+    }
+
+    printf("  %d workers of the C runtime, %zu pages\n", workers, pagesAllocated);
+    scaly_Page_deallocateExtensions(rootPage);
+    scaly_Task_dispose(__CurrentTask);
+    __CurrentPage = 0;
+    __CurrentTask = 0;
+    free(rootPage);
+    return failed;
+}
@@ -56,7 +56,7 @@ void scaly_Array_push(scaly_Array* this, void* item) {
 // Remove a value from the array
 void scaly_Array_remove(scaly_Array* this, void* t) {
     for (size_t i = 0; i < this->_size; i++) {
-        if (scaly_Array_elementAt(this, i) == t) {
+        if (*scaly_Array_elementAt(this, i) == t) {
             for (size_t j = i + 1; j < this->_size; j++)
                 *(scaly_Array_elementAt(this, j - 1)) = *(scaly_Array_elementAt(this, j));
             this->_size--;
@@ -1,7 +1,7 @@
 #include "scaly.h"
 
-extern scaly_Task* __CurrentTask;
-extern scaly_Page* __CurrentPage;
+extern _Thread_local scaly_Task* __CurrentTask;
+_Thread_local scaly_Page* __CurrentPage = 0;
 
 extern size_t pagesAllocated;
 
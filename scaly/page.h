@@ -5,6 +5,9 @@ static const int scaly_alignment = 8;
 static const size_t scaly_pageSize = 0x1000;
 static const size_t scaly_maxStackPages = 0x100;
 
+// Used in _Alignas, so it has to be an integer constant expression
+enum { scaly_cacheLineSize = 64 };
+
 typedef struct scaly_Page scaly_Page; struct scaly_Page {
     struct scaly_Page* currentPage;
     int nextObjectOffset;
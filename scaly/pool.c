@@ -1,26 +1,57 @@
 #include "scaly.h"
 
 scaly_Pool* scaly_Pool_new(scaly_Page* _page) {
-    scaly_Pool* this = (scaly_Pool*) scaly_Page_allocateObject(_page, sizeof(scaly_Pool));
+    scaly_Pool* this = (scaly_Pool*) scaly_alignToCacheLine(scaly_Page_allocateObject(_page, sizeof(scaly_Pool) + scaly_cacheLineSize - scaly_alignment));
 
-    this->chunks = scaly_Array_new(scaly_Page_getPage(this));
+    this->chunks = 0;
+    this->chunksLength = 0;
+    this->chunksCapacity = 0;
+    mtx_init(&this->mutex, mtx_plain);
 
     return this;
 }
 
+size_t scaly_Pool_allocatePages(scaly_Pool* this, scaly_Page** pages, size_t count) {
+    mtx_lock(&this->mutex);
+    size_t allocated = 0;
+    for (; allocated < count; allocated++) {
+        scaly_Page* page = scaly_Pool_allocatePage(this);
+        if (!page)
+            break;
+        pages[allocated] = page;
+    }
+    mtx_unlock(&this->mutex);
+    return allocated;
+}
+
+void scaly_Pool_deallocatePages(scaly_Pool* this, scaly_Page** pages, size_t count) {
+    mtx_lock(&this->mutex);
+    for (size_t i = 0; i < count; i++)
+        scaly_Pool_deallocatePage(this, pages[i]);
+    mtx_unlock(&this->mutex);
+}
+
 scaly_Page* scaly_Pool_allocatePage(scaly_Pool* this) {
-    size_t chunksLength = this->chunks->_size;
-    for (int i = 0; i < chunksLength; i++) {
-        scaly_Page* page = scaly_Chunk_allocatePage((scaly_Chunk*)scaly_Array_elementAt(this->chunks, i));
+    for (size_t i = 0; i < this->chunksLength; i++) {
+        scaly_Page* page = scaly_Chunk_allocatePage(this->chunks[i]);
         if (page)
             return page;
     }
 
+    if (this->chunksLength == this->chunksCapacity) {
+        size_t capacity = this->chunksCapacity ? this->chunksCapacity * 2 : 8;
+        scaly_Chunk** grown = (scaly_Chunk**)realloc(this->chunks, capacity * sizeof(scaly_Chunk*));
+        if (!grown)
+            return 0;
+        this->chunks = grown;
+        this->chunksCapacity = capacity;
+    }
+
     scaly_Chunk* chunk = scaly_Chunk_create();
     if (!chunk)
         return 0;
 
-    scaly_Array_push(this->chunks, chunk);
+    this->chunks[this->chunksLength++] = chunk;
     return scaly_Chunk_allocatePage(chunk);
 }
 
@@ -34,15 +65,24 @@ int scaly_Pool_deallocatePage(scaly_Pool* this, scaly_Page* page) {
         return 0;
     if (scaly_Chunk_isEmpty(chunk)) {
         scaly_Chunk_dispose(chunk);
-        scaly_Array_remove(this->chunks, chunk);
+        scaly_Pool_removeChunk(this, chunk);
     }
     return 1;
 }
 
+void scaly_Pool_removeChunk(scaly_Pool* this, scaly_Chunk* chunk) {
+    for (size_t i = 0; i < this->chunksLength; i++) {
+        if (this->chunks[i] == chunk) {
+            this->chunksLength--;
+            memmove(this->chunks + i, this->chunks + i + 1, (this->chunksLength - i) * sizeof(scaly_Chunk*));
+            return;
+        }
+    }
+}
+
 scaly_Chunk* scaly_Pool_getContainingChunk(scaly_Pool* this, scaly_Page* page) {
-    size_t chunksLength = this->chunks->_size;
-    for (int i = 0; i < chunksLength; i++) {
-        scaly_Chunk* chunk = (scaly_Chunk*)scaly_Array_elementAt(this->chunks, i);
+    for (size_t i = 0; i < this->chunksLength; i++) {
+        scaly_Chunk* chunk = this->chunks[i];
         scaly_Page* basePage = scaly_Page_getPage(chunk);
         scaly_Page* upperBound = (scaly_Page*)((char*)basePage + scaly_pageSize * scaly_numberOfPages);
         if ((page > basePage) && (page < upperBound))
@@ -52,8 +92,12 @@ scaly_Chunk* scaly_Pool_getContainingChunk(scaly_Pool* this, scaly_Page* page) {
 }
 
 void scaly_Pool_dispose(scaly_Pool* this) {
-    size_t chunksLength = this->chunks->_size;
-    for (int i = 0; i < chunksLength; i++)
-        scaly_Chunk_dispose((scaly_Chunk*)scaly_Array_elementAt(this->chunks, i));
+    for (size_t i = 0; i < this->chunksLength; i++)
+        scaly_Chunk_dispose(this->chunks[i]);
+    free(this->chunks);
+    this->chunks = 0;
+    this->chunksLength = 0;
+    this->chunksCapacity = 0;
+    mtx_destroy(&this->mutex);
 }
 
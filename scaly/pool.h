@@ -2,14 +2,23 @@
 #define __scaly__pool__
 #include "scaly.h"
 
+// The pool is shared by all tasks of a process, so it gets cache lines of its own.
+// The list of chunks is malloc'd, since a page allocated while the mutex is held
+// could come from this pool again. It is only touched under the mutex.
 typedef struct scaly_Pool scaly_Pool; struct scaly_Pool {
-    scaly_Array* chunks;
+    _Alignas(scaly_cacheLineSize) scaly_Chunk** chunks;
+    size_t chunksLength;
+    size_t chunksCapacity;
+    mtx_t mutex;
 };
 
 scaly_Pool* scaly_Pool_new(scaly_Page* _page);
+size_t scaly_Pool_allocatePages(scaly_Pool* this, scaly_Page** pages, size_t count);
+void scaly_Pool_deallocatePages(scaly_Pool* this, scaly_Page** pages, size_t count);
 scaly_Page* scaly_Pool_allocatePage(scaly_Pool* this);
 int scaly_Pool_deallocatePage(scaly_Pool* this, scaly_Page* page);
 void scaly_Pool_dispose(scaly_Pool* this);
 scaly_Chunk* scaly_Pool_getContainingChunk(scaly_Pool* this, scaly_Page* page);
+void scaly_Pool_removeChunk(scaly_Pool* this, scaly_Chunk* chunk);
 
 #endif // __Scaly__Pool__
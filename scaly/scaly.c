@@ -10,3 +10,11 @@ char* scaly_align(char* unalignedPointer) {
 
     return (char*)unalignedPointerAsNumber;
 }
+
+char* scaly_alignToCacheLine(char* unalignedPointer) {
+    long long pointerAsNumber = (long long)unalignedPointer;
+    pointerAsNumber += scaly_cacheLineSize - 1;
+    pointerAsNumber &= ~(long long)(scaly_cacheLineSize - 1);
+
+    return (char*)pointerAsNumber;
+}
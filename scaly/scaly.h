@@ -1,10 +1,16 @@
 #ifndef __scaly_scaly__
 #define __scaly_scaly__
 
+// For posix_memalign, which C11 alone does not declare
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <threads.h>
 
 #include "page.h"
 #include "array.h"
@@ -18,5 +24,6 @@
 #include "console.h"
 
 char* scaly_align(char*);
+char* scaly_alignToCacheLine(char*);
 
 #endif//__scaly_scaly__
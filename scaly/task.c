@@ -1,25 +1,113 @@
 #include "scaly.h"
 
+extern _Thread_local scaly_Page* __CurrentPage;
+_Thread_local scaly_Task* __CurrentTask = 0;
+
+static scaly_Task* scaly_Task_allocate(scaly_Page* _page) {
+    scaly_Task* this = (scaly_Task*) scaly_alignToCacheLine(scaly_Page_allocateObject(_page, sizeof(scaly_Task) + scaly_cacheLineSize - scaly_alignment));
+    this->pagesAllocated = 0;
+    this->pagesReleased = 0;
+    this->poolAccesses = 0;
+    this->magazineCount = 0;
+    return this;
+}
+
 scaly_Task* scaly_Task_new(scaly_Page* _page) {
-    scaly_Task* this = (scaly_Task*) scaly_Page_allocateObject(_page, sizeof(scaly_Task));
+    scaly_Task* this = scaly_Task_allocate(_page);
 
     this->pool = scaly_Pool_new(scaly_Page_getPage(this));
 
     return this;
 }
 
+scaly_Task* scaly_Task_newFromParent(scaly_Page* _page, scaly_Task* parentTask) {
+    scaly_Task* this = scaly_Task_allocate(_page);
+
+    this->pool = parentTask->pool;
+
+    return this;
+}
+
 scaly_Page* scaly_Task_getExtensionPage(scaly_Task* this) {
-    scaly_Page* page = scaly_Pool_allocatePage(this->pool);
-    if (!page)
-        return 0;
-    return page; }
+    if (!this->magazineCount) {
+        // Refill half of the magazine from the pool
+        this->poolAccesses++;
+        this->magazineCount = scaly_Pool_allocatePages(this->pool, this->magazine, scaly_Task_magazineSize / 2);
+        if (!this->magazineCount)
+            return 0;
+    }
+
+    this->pagesAllocated++;
+    this->magazineCount--;
+    return this->magazine[this->magazineCount];
+}
 
 void scaly_Task_releaseExtensionPage(scaly_Task* this, scaly_Page* page) {
-    if (!scaly_Pool_deallocatePage(this->pool, page))
+    if (scaly_Page_isOversized(page)) {
         // This is an oversized page which has to be free'd directly
         free(page);
+        return;
+    }
+
+    // Give back the older half of the magazine if it is full
+    if (this->magazineCount == scaly_Task_magazineSize)
+        scaly_Task_flushMagazine(this, scaly_Task_magazineSize / 2);
+
+    this->pagesReleased++;
+    this->magazine[this->magazineCount] = page;
+    this->magazineCount++;
+}
+
+void scaly_Task_flushMagazine(scaly_Task* this, size_t count) {
+    this->poolAccesses++;
+    scaly_Pool_deallocatePages(this->pool, this->magazine, count);
+    this->magazineCount -= count;
+    memmove(this->magazine, this->magazine + count, this->magazineCount * sizeof(scaly_Page*));
 }
 
 void scaly_Task_dispose(scaly_Task* this) {
+    scaly_Task_flushMagazine(this, this->magazineCount);
     scaly_Pool_dispose(this->pool);
 }
+
+static int scaly_Task_run(void* argument) {
+    scaly_Worker* worker = (scaly_Worker*)argument;
+
+    // Allocate the root page for the worker thread
+    scaly_Page* rootPage = 0;
+    posix_memalign((void**)&rootPage, scaly_pageSize, scaly_pageSize * scaly_maxStackPages);
+    if (!rootPage)
+        return -1;
+    scaly_Page_reset(rootPage);
+    __CurrentPage = rootPage;
+    __CurrentTask = scaly_Task_newFromParent(rootPage, worker->parentTask);
+
+    int ret = worker->function(worker->argument);
+
+    scaly_Page_deallocateExtensions(rootPage);
+    scaly_Task_flushMagazine(__CurrentTask, __CurrentTask->magazineCount);
+    __CurrentPage = 0;
+    __CurrentTask = 0;
+    free(rootPage);
+    return ret;
+}
+
+scaly_Worker* scaly_Task_spawn(scaly_Page* _page, int (*function)(void* argument), void* argument) {
+    scaly_Worker* worker = (scaly_Worker*) scaly_Page_allocateObject(_page, sizeof(scaly_Worker));
+    worker->parentTask = __CurrentTask;
+    worker->function = function;
+    worker->argument = argument;
+
+    if (thrd_create(&worker->thread, scaly_Task_run, worker) != thrd_success)
+        return 0;
+
+    return worker;
+}
+
+int scaly_Task_join(scaly_Worker* worker) {
+    int ret = -1;
+    if (thrd_join(worker->thread, &ret) != thrd_success)
+        return -1;
+
+    return ret;
+}
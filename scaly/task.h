@@ -3,15 +3,42 @@
 
 #include "scaly.h"
 
+// Number of free pages a task caches before it goes to the pool
+enum { scaly_Task_magazineSize = 32 };
+
+// Each thread has a task of its own which lives on cache lines of its own
 typedef struct scaly_Task scaly_Task;
 struct scaly_Task {
-    scaly_Pool* pool;
+    // The pool is shared with the tasks of the worker threads
+    _Alignas(scaly_cacheLineSize) scaly_Pool* pool;
+
+    // Statistics, only ever touched by the owning thread
+    size_t pagesAllocated;
+    size_t pagesReleased;
+    size_t poolAccesses;
+
+    // Free pages of this task
+    size_t magazineCount;
+    scaly_Page* magazine[scaly_Task_magazineSize];
+};
+
+// A thread running a function with its own region stack and task
+typedef struct scaly_Worker scaly_Worker;
+struct scaly_Worker {
+    thrd_t thread;
+    scaly_Task* parentTask;
+    int (*function)(void* argument);
+    void* argument;
 };
 
 scaly_Task* scaly_Task_new(scaly_Page* _page);
+scaly_Task* scaly_Task_newFromParent(scaly_Page* _page, scaly_Task* parentTask);
 scaly_Page* scaly_Task_getExtensionPage(scaly_Task* this);
 void scaly_Task_releaseExtensionPage(scaly_Task* this, scaly_Page* page);
+void scaly_Task_flushMagazine(scaly_Task* this, size_t count);
 void scaly_Task_dispose(scaly_Task* this);
+scaly_Worker* scaly_Task_spawn(scaly_Page* _page, int (*function)(void* argument), void* argument);
+int scaly_Task_join(scaly_Worker* worker);
 scaly_Page* allocatePage(scaly_Task* this);
 
 #endif // __scaly_task__
@@ -1,8 +1,8 @@
 #include "scalyc.h"
 #include <errno.h>
 
-scaly_Page* __CurrentPage;
-scaly_Task* __CurrentTask;
+extern _Thread_local scaly_Page* __CurrentPage;
+extern _Thread_local scaly_Task* __CurrentTask;
 
 int main(int argc, char **argv) {
 
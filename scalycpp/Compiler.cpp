@@ -5,13 +5,25 @@ namespace scalycpp {
 void Compiler::compileFiles(Options* options) {
     _Region _region; _Page* _p = _region.get();
     _Array<string>* files = options->files;
-    _Array<string>* sources = new(_p) _Array<string>();
+    _Array<FileRead>* reads = new(_p) _Array<FileRead>();
     string* file = nullptr;
     size_t _files_length = files->length();
     for (size_t _i = 0; _i < _files_length; _i++) {
         file = *(*files)[_i];
         {
-            auto _source_result = File::readToString(sources->_getPage(), _p, file);
+            FileRead* read = File::readToStringAsync(reads->_getPage(), file);
+            reads->push(read);
+        }
+    }
+    _Array<string>* sources = new(_p) _Array<string>();
+    bool readable = true;
+    size_t readIndex = 0;
+    FileRead* read = nullptr;
+    size_t _reads_length = reads->length();
+    for (size_t _i = 0; _i < _reads_length; _i++) {
+        read = *(*reads)[_i];
+        {
+            auto _source_result = read->get(sources->_getPage(), _p);
             string* source = nullptr;
             if (_source_result.succeeded()) {
                 source = _source_result.getResult();
@@ -19,23 +31,42 @@ void Compiler::compileFiles(Options* options) {
             else if (_source_result._getErrorCode() == _FileErrorCode_noSuchFileOrDirectory) {
                 {
                     _Region _region; _Page* _p = _region.get();
-                    VarString* msg = new(_p) VarString("Can't read file: ");
-                    msg->append(file);
-                    msg->append("\n");
-                    string* message = new(_p) string(msg);
+                    string* message = SCALY_FORMAT(_p, "Can't read file: {}\n", *(*files)[readIndex]);
                     auto _print_error = print(_p, message);
                     if (_print_error) { switch (_print_error->_getErrorCode()) {
                         default: {
-                        return;
+                        {
+                        }
+                        break;
                         }
                     } }
-                    return;
+                    readable = false;
+                }
+            }
+            else if (_source_result._getErrorCode() == _FileErrorCode_invalidUtf8) {
+                {
+                    _Region _region; _Page* _p = _region.get();
+                    string* message = SCALY_FORMAT(_p, "File is not valid UTF-8: {}\n", *(*files)[readIndex]);
+                    auto _print_error = print(_p, message);
+                    if (_print_error) { switch (_print_error->_getErrorCode()) {
+                        default: {
+                        {
+                        }
+                        break;
+                        }
+                    } }
+                    readable = false;
                 }
             }
             sources->push(source);
+            readIndex++;
         }
     }
+    if (!readable) {
+        return;
+    }
     _Array<Module>* modules = new(_p) _Array<Module>();
+    Interner* symbols = new(_p) Interner();
     size_t index = 0;
     string* source = nullptr;
     size_t _sources_length = sources->length();
@@ -43,26 +74,18 @@ void Compiler::compileFiles(Options* options) {
         source = *(*sources)[_i];
         {
             string* moduleName = Path::getFileNameWithoutExtension(modules->_getPage(), *(*files)[index]);
-            auto _module_result = parseUnit(modules->_getPage(), _p, moduleName, source);
+            auto _module_result = parseUnit(modules->_getPage(), _p, moduleName, source, symbols);
             Module* module = nullptr;
             if (_module_result.succeeded()) {
                 module = _module_result.getResult();
             }
             else if (_module_result._getErrorCode() == _CompilerErrorCode_parser) {
-                size_t line = _module_result.getError()->get_parser()->line;
-                size_t column = _module_result.getError()->get_parser()->column;
+                auto _payload = _module_result.getError()->get_parser();
+                size_t line = _payload->line;
+                size_t column = _payload->column;
                 {
                     _Region _region; _Page* _p = _region.get();
-                    VarString* msg = new(_p) VarString("Syntax error in ");
-                    msg->append(*(*files)[index]);
-                    msg->append(" at ");
-                    string* lineString = Number::toString(_p, line);
-                    msg->append(lineString);
-                    msg->append(", ");
-                    string* columnString = Number::toString(_p, column);
-                    msg->append(columnString);
-                    msg->append("\n");
-                    string* message = new(_p) string(msg);
+                    string* message = SCALY_FORMAT(_p, "Syntax error in {} at {}, {}\n", *(*files)[index], line, column);
                     auto _print_error = print(_p, message);
                     if (_print_error) { switch (_print_error->_getErrorCode()) {
                         default: {
@@ -83,9 +106,9 @@ void Compiler::compileFiles(Options* options) {
         item = *(*modules)[_i];
         item->parent = program;
     }
-    HeaderVisitor* headerVisitor = new(_p) HeaderVisitor(options->directory);
+    HeaderVisitor* headerVisitor = new(_p) HeaderVisitor(options->directory, symbols);
     program->accept(headerVisitor);
-    SourceVisitor* sourceVisitor = new(_p) SourceVisitor(options->directory);
+    SourceVisitor* sourceVisitor = new(_p) SourceVisitor(options->directory, symbols);
     program->accept(sourceVisitor);
     ModelVisitor* modelVisitor = new(_p) ModelVisitor();
     program->accept(modelVisitor);
@@ -101,19 +124,20 @@ void Compiler::compileFiles(Options* options) {
     } }
 }
 
-_Result<Module, CompilerError> Compiler::parseUnit(_Page* _rp, _Page* _ep, string* moduleName, string* text) {
+_Result<Module, CompilerError> Compiler::parseUnit(_Page* _rp, _Page* _ep, string* moduleName, string* text, Interner* symbols) {
     _Region _region; _Page* _p = _region.get();
-    Parser* parser = new(_p) Parser(moduleName, text);
+    Parser* parser = new(_p) Parser(moduleName, text, symbols);
     auto _module_result = parser->parseModule(_rp, _ep);
     Module* module = nullptr;
     if (_module_result.succeeded()) {
         module = _module_result.getResult();
     }
     else if (_module_result._getErrorCode() == _ParserErrorCode_syntax) {
-        size_t line = _module_result.getError()->get_syntax()->line;
-        size_t column = _module_result.getError()->get_syntax()->column;
+        auto _payload = _module_result.getError()->get_syntax();
+        size_t line = _payload->line;
+        size_t column = _payload->column;
         {
-            return _Result<Module, CompilerError>(new(_ep) CompilerError(new(_ep) _CompilerError_parser(line, column)));
+            return _Result<Module, CompilerError>(CompilerError(_CompilerError_parser(line, column)));
         }
     }
     return module;
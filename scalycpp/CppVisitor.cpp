@@ -12,7 +12,15 @@ bool CppVisitor::hasArrayPostfix(Type* type) {
     return false;
 }
 
-void CppVisitor::appendCppType(VarString* s, Type* type) {
+bool CppVisitor::isClass(string* name) {
+    if (name == symbols->stringClass || name == symbols->varStringClass || name == symbols->numberClass || name == symbols->fileClass || name == symbols->fileReadClass || name == symbols->directoryClass || name == symbols->pathClass || name == symbols->directoryErrorClass || name == symbols->fileErrorClass || name == symbols->parserErrorClass || name == symbols->cppErrorClass || name == symbols->compilerErrorClass || name == symbols->stringSetClass || name == symbols->internerClass || name == symbols->stringBuilderClass || name == symbols->ropeClass)
+        return true;
+    if (classes->contains(name))
+        return true;
+    return false;
+}
+
+void CppVisitor::appendCppType(Rope* s, Type* type) {
     if (hasArrayPostfix(type)) {
         s->append("_Array<");
         appendCppTypeName(s, type);
@@ -26,14 +34,14 @@ void CppVisitor::appendCppType(VarString* s, Type* type) {
     }
 }
 
-void CppVisitor::appendCppTypeName(VarString* s, Type* type) {
+void CppVisitor::appendCppTypeName(Rope* s, Type* type) {
     string* typeName = type->name;
-    if (typeName->equals("number")) {
+    if (typeName == symbols->numberType) {
         s->append("size_t");
         return;
     }
     else {
-        if (typeName->equals("char")) {
+        if (typeName == symbols->charType) {
             s->append("char");
             return;
         }
@@ -74,7 +82,7 @@ void CppVisitor::collectInheritancesInModule(Module* module) {
             {
                 if (statement->_isClassDeclaration()) {
                     ClassDeclaration* classDeclaration = (ClassDeclaration*)statement;
-                    classes->push(classDeclaration->name);
+                    classes->add(classDeclaration->name);
                     if (classDeclaration->typeInheritanceClause != nullptr) {
                         TypeInheritanceClause* inheritanceClause = classDeclaration->typeInheritanceClause;
                         Inheritance* inheritance = nullptr;
@@ -122,12 +130,36 @@ Inherits::Inherits(string* className) {
     inheritors = new(_getPage()->allocateExclusivePage()) _Array<string>();
 }
 
-HeaderVisitor::HeaderVisitor(string* outputDirectory) {
+CppSymbols::CppSymbols(Interner* symbols) {
+    stringClass = symbols->intern(_getPage(), "string");
+    varStringClass = symbols->intern(_getPage(), "VarString");
+    numberClass = symbols->intern(_getPage(), "Number");
+    fileClass = symbols->intern(_getPage(), "File");
+    fileReadClass = symbols->intern(_getPage(), "FileRead");
+    directoryClass = symbols->intern(_getPage(), "Directory");
+    pathClass = symbols->intern(_getPage(), "Path");
+    directoryErrorClass = symbols->intern(_getPage(), "DirectoryError");
+    fileErrorClass = symbols->intern(_getPage(), "FileError");
+    parserErrorClass = symbols->intern(_getPage(), "ParserError");
+    cppErrorClass = symbols->intern(_getPage(), "CppError");
+    compilerErrorClass = symbols->intern(_getPage(), "CompilerError");
+    stringSetClass = symbols->intern(_getPage(), "StringSet");
+    internerClass = symbols->intern(_getPage(), "Interner");
+    stringBuilderClass = symbols->intern(_getPage(), "StringBuilder");
+    ropeClass = symbols->intern(_getPage(), "Rope");
+    numberType = symbols->intern(_getPage(), "number");
+    charType = symbols->intern(_getPage(), "char");
+    printFunction = symbols->intern(_getPage(), "print");
+    formatFunction = symbols->intern(_getPage(), "format");
+}
+
+HeaderVisitor::HeaderVisitor(string* outputDirectory, Interner* theSymbols) {
     directory = outputDirectory;
     headerFile = nullptr;
     mainHeaderFile = nullptr;
     inherits = new(_getPage()->allocateExclusivePage()) _Array<Inherits>();
-    classes = new(_getPage()->allocateExclusivePage()) _Array<string>();
+    classes = new(_getPage()->allocateExclusivePage()) StringSet();
+    symbols = new(_getPage()->allocateExclusivePage()) CppSymbols(theSymbols);
 }
 
 bool HeaderVisitor::openProgram(Program* program) {
@@ -180,7 +212,7 @@ bool HeaderVisitor::openModule(Module* module) {
         if (!fileName->equals(programName)) {
             if (headerFile != nullptr)
                 headerFile->_getPage()->clear();
-            headerFile = new(headerFile == nullptr ? _getPage()->allocateExclusivePage() : headerFile->_getPage()) VarString();
+            headerFile = new(headerFile == nullptr ? _getPage()->allocateExclusivePage() : headerFile->_getPage()) Rope();
             headerFile->append("#ifndef __");
             headerFile->append(programName);
             headerFile->append("__");
@@ -290,7 +322,7 @@ void HeaderVisitor::closeEnumDeclaration(EnumDeclaration* enumDeclaration) {
     headerFile->append(enumDeclarationName);
     headerFile->append("(_");
     headerFile->append(enumDeclarationName);
-    headerFile->append("Code errorCode)\n    : errorCode(errorCode), errorInfo(0) {}\n\n");
+    headerFile->append("Code errorCode)\n    : errorCode(errorCode) {}\n\n");
     if (enumDeclaration->members != nullptr) {
         EnumMember* member = nullptr;
         size_t _enumDeclaration_length = enumDeclaration->members->length();
@@ -304,20 +336,22 @@ void HeaderVisitor::closeEnumDeclaration(EnumDeclaration* enumDeclaration) {
                     headerFile->append(enumDeclarationName);
                     headerFile->append("_");
                     headerFile->append(member->enumCase->name);
-                    headerFile->append("* ");
+                    headerFile->append(" ");
                     headerFile->append(member->enumCase->name);
                     headerFile->append(")\n    : errorCode(_");
                     headerFile->append(enumDeclarationName);
                     headerFile->append("Code_");
                     headerFile->append(member->enumCase->name);
-                    headerFile->append("), errorInfo(");
+                    headerFile->append("), ");
+                    headerFile->append(member->enumCase->name);
+                    headerFile->append("(");
                     headerFile->append(member->enumCase->name);
                     headerFile->append(") {}\n\n");
                 }
             }
         }
     }
-    headerFile->append("    long _getErrorCode();\n    void* _getErrorInfo();\n\n");
+    headerFile->append("    long _getErrorCode();\n\n");
     if (enumDeclaration->members != nullptr) {
         EnumMember* member = nullptr;
         size_t _enumDeclaration_length = enumDeclaration->members->length();
@@ -338,7 +372,33 @@ void HeaderVisitor::closeEnumDeclaration(EnumDeclaration* enumDeclaration) {
     }
     headerFile->append("\nprivate:\n    _");
     headerFile->append(enumDeclarationName);
-    headerFile->append("Code errorCode;\n    void* errorInfo;\n};");
+    headerFile->append("Code errorCode;\n");
+    if (enumDeclaration->members != nullptr) {
+        bool hasPayload = false;
+        EnumMember* member = nullptr;
+        size_t _enumDeclaration_length = enumDeclaration->members->length();
+        for (size_t _i = 0; _i < _enumDeclaration_length; _i++) {
+            member = *(*enumDeclaration->members)[_i];
+            {
+                if (member->parameterClause) {
+                    if (!hasPayload) {
+                        headerFile->append("    union {\n");
+                        hasPayload = true;
+                    }
+                    headerFile->append("        _");
+                    headerFile->append(enumDeclarationName);
+                    headerFile->append("_");
+                    headerFile->append(member->enumCase->name);
+                    headerFile->append(" ");
+                    headerFile->append(member->enumCase->name);
+                    headerFile->append(";\n");
+                }
+            }
+        }
+        if (hasPayload)
+            headerFile->append("    };\n");
+    }
+    headerFile->append("};");
 }
 
 bool HeaderVisitor::openClassDeclaration(ClassDeclaration* classDeclaration) {
@@ -516,22 +576,6 @@ void HeaderVisitor::writeParameter(string* name, Type* parameterType) {
     }
 }
 
-bool HeaderVisitor::isClass(string* name) {
-    if (name->equals("string") || name->equals("VarString") || name->equals("File") || name->equals("Directory") || name->equals("Path") || name->equals("DirectoryError") || name->equals("FileError") || name->equals("ParserError") || name->equals("CppError") || name->equals("CompilerError"))
-        return true;
-    string* className = nullptr;
-    size_t _classes_length = classes->length();
-    for (size_t _i = 0; _i < _classes_length; _i++) {
-        className = *(*classes)[_i];
-        {
-            if (className->equals(name)) {
-                return true;
-            }
-        }
-    }
-    return false;
-}
-
 void HeaderVisitor::closeConstParameter(ConstParameter* constParameter) {
     headerFile->append(constParameter->name);
 }
@@ -626,7 +670,7 @@ void HeaderVisitor::closeType(Type* type) {
 void HeaderVisitor::buildMainHeaderFileString(Program* program) {
     if (mainHeaderFile != nullptr)
         mainHeaderFile->_getPage()->clear();
-    mainHeaderFile = new(mainHeaderFile == nullptr ? _getPage()->allocateExclusivePage() : mainHeaderFile->_getPage()) VarString();
+    mainHeaderFile = new(mainHeaderFile == nullptr ? _getPage()->allocateExclusivePage() : mainHeaderFile->_getPage()) Rope();
     mainHeaderFile->append("#ifndef __scaly__");
     mainHeaderFile->append(program->name);
     mainHeaderFile->append("__\n#define __scaly__");
@@ -668,11 +712,12 @@ void HeaderVisitor::collectInheritances(Program* program) {
 
 bool HeaderVisitor::_isHeaderVisitor() { return (true); }
 
-SourceVisitor::SourceVisitor(string* outputDirectory) {
+SourceVisitor::SourceVisitor(string* outputDirectory, Interner* theSymbols) {
     directory = outputDirectory;
     sourceFile = nullptr;
     inherits = new(_getPage()->allocateExclusivePage()) _Array<Inherits>();
-    classes = new(_getPage()->allocateExclusivePage()) _Array<string>();
+    classes = new(_getPage()->allocateExclusivePage()) StringSet();
+    symbols = new(_getPage()->allocateExclusivePage()) CppSymbols(theSymbols);
 }
 
 bool SourceVisitor::openProgram(Program* program) {
@@ -700,7 +745,7 @@ bool SourceVisitor::openModule(Module* module) {
     string* programName = ((Program*)module->parent)->name;
     if (sourceFile != nullptr)
         sourceFile->_getPage()->clear();
-    sourceFile = new(sourceFile == nullptr ? _getPage()->allocateExclusivePage() : sourceFile->_getPage()) VarString(0, 4096);
+    sourceFile = new(sourceFile == nullptr ? _getPage()->allocateExclusivePage() : sourceFile->_getPage()) Rope();
     sourceFile->append("#include \"");
     sourceFile->append(programName);
     sourceFile->append(".h\"\nusing namespace scaly;\n");
@@ -802,9 +847,7 @@ bool SourceVisitor::openEnumDeclaration(EnumDeclaration* enumDeclaration) {
     string* enumDeclarationName = enumDeclaration->name;
     sourceFile->append("long ");
     sourceFile->append(enumDeclarationName);
-    sourceFile->append("::_getErrorCode() {\n    return (long)errorCode;\n}\n\nvoid* ");
-    sourceFile->append(enumDeclarationName);
-    sourceFile->append("::_getErrorInfo() {\n    return errorInfo;\n}\n\n");
+    sourceFile->append("::_getErrorCode() {\n    return (long)errorCode;\n}\n\n");
     return true;
 }
 
@@ -976,7 +1019,7 @@ bool SourceVisitor::openSimpleExpression(SimpleExpression* simpleExpression) {
                     if (assignment->parent->_isSimpleExpression()) {
                         SimpleExpression* simpleExpression = (SimpleExpression*)(assignment->parent);
                         PostfixExpression* leftSide = simpleExpression->prefixExpression->expression;
-                        if (leftSide->primaryExpression->_isIdentifierExpression()) {
+                        if ((leftSide->primaryExpression->_isIdentifierExpression()) && (leftSide->postfixes == nullptr)) {
                             IdentifierExpression* memberExpression = (IdentifierExpression*)(leftSide->primaryExpression);
                             string* memberName = memberExpression->name;
                             ClassDeclaration* classDeclaration = getClassDeclaration(assignment);
@@ -1033,7 +1076,7 @@ bool SourceVisitor::openSimpleExpression(SimpleExpression* simpleExpression) {
                                 PostfixExpression* postfixExpression = (PostfixExpression*)(functionCall->parent);
                                 if (postfixExpression->primaryExpression->_isIdentifierExpression()) {
                                     IdentifierExpression* identifierExpression = (IdentifierExpression*)(postfixExpression->primaryExpression);
-                                    if (identifierExpression->name->equals("print")) {
+                                    if (identifierExpression->name == symbols->printFunction) {
                                         sourceFile->append("{\n    auto _File_error = ");
                                     }
                                 }
@@ -1090,7 +1133,7 @@ void SourceVisitor::closeSimpleExpression(SimpleExpression* simpleExpression) {
                                 PostfixExpression* postfixExpression = (PostfixExpression*)(functionCall->parent);
                                 if (postfixExpression->primaryExpression->_isIdentifierExpression()) {
                                     IdentifierExpression* identifierExpression = (IdentifierExpression*)(postfixExpression->primaryExpression);
-                                    if (identifierExpression->name->equals("print")) {
+                                    if (identifierExpression->name == symbols->printFunction) {
                                         sourceFile->append("    if (_File_error)\n        return _File_error;\n}\n");
                                     }
                                 }
@@ -1212,23 +1255,6 @@ void SourceVisitor::writeParameter(string* name, Type* parameterType) {
     }
 }
 
-bool SourceVisitor::isClass(string* name) {
-    if (name->equals("string") || name->equals("VarString") || name->equals("Number") || name->equals("File") || name->equals("Directory") || name->equals("Path") || name->equals("DirectoryError") || name->equals("FileError") || name->equals("ParserError") || name->equals("CppError") || name->equals("CompilerError")) {
-        return true;
-    }
-    string* className = nullptr;
-    size_t _classes_length = classes->length();
-    for (size_t _i = 0; _i < _classes_length; _i++) {
-        className = *(*classes)[_i];
-        {
-            if (className->equals(name)) {
-                return true;
-            }
-        }
-    }
-    return false;
-}
-
 bool SourceVisitor::openVarParameter(VarParameter* varParameter) {
     writeParameter(varParameter->name, varParameter->parameterType);
     return false;
@@ -1288,11 +1314,9 @@ void SourceVisitor::closeEnumMember(EnumMember* enumMember) {
         sourceFile->append(enumDeclarationName);
         sourceFile->append("::get_");
         sourceFile->append(enumMember->enumCase->name);
-        sourceFile->append("() {\n    return (_");
-        sourceFile->append(enumDeclarationName);
-        sourceFile->append("_");
+        sourceFile->append("() {\n    return &");
         sourceFile->append(enumMember->enumCase->name);
-        sourceFile->append("*)errorInfo;\n}\n\n");
+        sourceFile->append(";\n}\n\n");
     }
 }
 
@@ -1310,11 +1334,7 @@ size_t SourceVisitor::level(SyntaxNode* syntaxNode) {
 }
 
 void SourceVisitor::indent(size_t level) {
-    size_t i = 0;
-    while (i < level) {
-        sourceFile->append("    ");
-        i++;
-    }
+    sourceFile->appendIndentation(level);
 }
 
 bool SourceVisitor::openPrefixExpression(PrefixExpression* prefixExpression) {
@@ -1584,6 +1604,13 @@ bool SourceVisitor::openCatchClause(CatchClause* catchClause) {
                         }
                     }
                     if (catchClause->catchPattern->_isIdentifierCatchPattern()) {
+                        indent(level(catchClause));
+                        sourceFile->append("auto _payload = _");
+                        sourceFile->append(identifierPattern->identifier);
+                        sourceFile->append("_result.getError()->get_");
+                        if (errorType != nullptr)
+                            sourceFile->append(errorType);
+                        sourceFile->append("();\n");
                         TuplePatternElement* element = nullptr;
                         size_t _bindingPattern_length = bindingPattern->elements->length();
                         for (size_t _i = 0; _i < _bindingPattern_length; _i++) {
@@ -1591,12 +1618,7 @@ bool SourceVisitor::openCatchClause(CatchClause* catchClause) {
                             {
                                 indent(level(catchClause));
                                 element->accept(this);
-                                sourceFile->append(" = _");
-                                sourceFile->append(identifierPattern->identifier);
-                                sourceFile->append("_result.getError()->get_");
-                                if (errorType != nullptr)
-                                    sourceFile->append(errorType);
-                                sourceFile->append("()->");
+                                sourceFile->append(" = _payload->");
                                 if (element->pattern->_isIdentifierPattern()) {
                                     sourceFile->append(((IdentifierPattern*)element->pattern)->identifier);
                                 }
@@ -1813,6 +1835,15 @@ bool SourceVisitor::isLastExpressionElement(ExpressionElement* expressionElement
 }
 
 void SourceVisitor::visitIdentifierExpression(IdentifierExpression* identifierExpression) {
+    if (identifierExpression->name == symbols->formatFunction && identifierExpression->parent->_isPostfixExpression()) {
+        PostfixExpression* postfixExpression = (PostfixExpression*)(identifierExpression->parent);
+        if (postfixExpression->postfixes != nullptr) {
+            if ((*(*postfixExpression->postfixes)[0])->_isFunctionCall()) {
+                sourceFile->append("SCALY_FORMAT");
+                return;
+            }
+        }
+    }
     sourceFile->append(identifierExpression->name);
 }
 
@@ -2040,7 +2071,7 @@ bool SourceVisitor::openParenthesizedExpression(ParenthesizedExpression* parenth
                 PostfixExpression* postfixExpression = (PostfixExpression*)(functionCall->parent);
                 if (postfixExpression->primaryExpression->_isIdentifierExpression()) {
                     IdentifierExpression* identifierExpression = (IdentifierExpression*)(postfixExpression->primaryExpression);
-                    if (identifierExpression->name->equals("print")) {
+                    if (identifierExpression->name == symbols->printFunction) {
                         sourceFile->append("_ep");
                         parameterInserted = true;
                     }
@@ -2233,11 +2264,10 @@ bool SourceVisitor::openThrowExpression(ThrowExpression* throwExpression) {
             }
         }
         if (buildError) {
-            sourceFile->append("new(_ep) ");
+            if (returnType == nullptr)
+                sourceFile->append("new(_ep) ");
             sourceFile->append(thrownType);
             sourceFile->append("(");
-            if (throwExpression->arguments != nullptr)
-                sourceFile->append("new(_ep) ");
             sourceFile->append("_");
             sourceFile->append(thrownType);
             if (throwExpression->arguments == nullptr)
@@ -2276,17 +2306,18 @@ string* SourceVisitor::getReturnType(_Page* _rp, SyntaxNode* syntaxNode) {
     if (functionDeclaration != nullptr) {
         FunctionResult* functionResult = functionDeclaration->signature->result;
         if (functionResult != nullptr) {
-            VarString* ret = new(_rp) VarString();
+            _Region _region; _Page* _p = _region.get();
+            Rope* ret = new(_p) Rope();
             if (hasArrayPostfix(functionResult->resultType)) {
                 Type* type = functionResult->resultType;
                 ret->append("_Array<");
                 appendCppTypeName(ret, type);
                 ret->append(">");
-                return new(_rp) string(ret);
+                return ret->toString(_rp);
             }
             else {
                 appendCppTypeName(ret, functionResult->resultType);
-                return new(_rp) string(ret);
+                return ret->toString(_rp);
             }
         }
     }
@@ -2298,17 +2329,18 @@ string* SourceVisitor::getThrownType(_Page* _rp, SyntaxNode* syntaxNode) {
     if (functionDeclaration != nullptr) {
         ThrowsClause* throwsClause = functionDeclaration->signature->throwsClause;
         if (throwsClause != nullptr) {
-            VarString* ret = new(_rp) VarString();
+            _Region _region; _Page* _p = _region.get();
+            Rope* ret = new(_p) Rope();
             if (hasArrayPostfix(throwsClause->throwsType)) {
                 Type* type = throwsClause->throwsType;
                 ret->append("_Array<");
                 appendCppTypeName(ret, type);
                 ret->append(">");
-                return new(_rp) string(ret);
+                return ret->toString(_rp);
             }
             else {
                 appendCppTypeName(ret, throwsClause->throwsType);
-                return new(_rp) string(ret);
+                return ret->toString(_rp);
             }
         }
     }
@@ -2358,7 +2390,7 @@ string* SourceVisitor::getPageOfVariable(_Page* _rp, string* name, CodeBlock* co
             if (bindingInitializer == nullptr)
                 continue;
             IdentifierPattern* identifierPattern = bindingInitializer->initializer->pattern;
-            if (identifierPattern->identifier->equals(name)) {
+            if (identifierPattern->identifier == name) {
                 if (identifierPattern->annotationForType != nullptr) {
                     if (identifierPattern->annotationForType->annotationForType->lifeTime == nullptr) {
                         return new(_rp) string("_rp");
@@ -6,14 +6,17 @@ namespace scalycpp {
 
 class Inherits;
 
+class CppSymbols;
+
 class CppVisitor : public CommonVisitor {
 public:
     _Array<Inherits>* inherits;
-    _Array<string>* classes;
+    StringSet* classes;
+    CppSymbols* symbols;
     virtual bool hasArrayPostfix(Type* type);
-    virtual bool isClass(string* name) = 0;
-    virtual void appendCppType(VarString* s, Type* type);
-    virtual void appendCppTypeName(VarString* s, Type* type);
+    virtual bool isClass(string* name);
+    virtual void appendCppType(Rope* s, Type* type);
+    virtual void appendCppTypeName(Rope* s, Type* type);
     virtual void collectDerivedClasses(_Array<string>* derivedClasses, string* className);
     virtual void appendDerivedClasses(_Array<string>* derivedClasses, _Array<string>* inheritors);
     virtual void collectInheritancesInModule(Module* module);
@@ -32,12 +35,38 @@ public:
 
 };
 
+class CppSymbols : public Object {
+public:
+    string* stringClass;
+    string* varStringClass;
+    string* numberClass;
+    string* fileClass;
+    string* fileReadClass;
+    string* directoryClass;
+    string* pathClass;
+    string* directoryErrorClass;
+    string* fileErrorClass;
+    string* parserErrorClass;
+    string* cppErrorClass;
+    string* compilerErrorClass;
+    string* stringSetClass;
+    string* internerClass;
+    string* stringBuilderClass;
+    string* ropeClass;
+    string* numberType;
+    string* charType;
+    string* printFunction;
+    string* formatFunction;
+    CppSymbols(Interner* symbols);
+
+};
+
 class HeaderVisitor : public CppVisitor {
 public:
     string* directory;
-    VarString* headerFile;
-    VarString* mainHeaderFile;
-    HeaderVisitor(string* outputDirectory);
+    Rope* headerFile;
+    Rope* mainHeaderFile;
+    HeaderVisitor(string* outputDirectory, Interner* theSymbols);
     virtual bool openProgram(Program* program);
     virtual bool openModule(Module* module);
     virtual void closeModule(Module* module);
@@ -55,7 +84,6 @@ public:
     virtual void closeParameterClause(ParameterClause* parameterClause);
     virtual bool openConstParameter(ConstParameter* constParameter);
     virtual void writeParameter(string* name, Type* parameterType);
-    virtual bool isClass(string* name);
     virtual void closeConstParameter(ConstParameter* constParameter);
     virtual bool openVarParameter(VarParameter* varParameter);
     virtual void closeVarParameter(VarParameter* varParameter);
@@ -75,8 +103,8 @@ public:
 class SourceVisitor : public CppVisitor {
 public:
     string* directory;
-    VarString* sourceFile;
-    SourceVisitor(string* outputDirectory);
+    Rope* sourceFile;
+    SourceVisitor(string* outputDirectory, Interner* theSymbols);
     virtual bool openProgram(Program* program);
     virtual bool openModule(Module* module);
     virtual void closeModule(Module* module);
@@ -103,7 +131,6 @@ public:
     virtual void closeParameterClause(ParameterClause* parameterClause);
     virtual bool openConstParameter(ConstParameter* constParameter);
     virtual void writeParameter(string* name, Type* parameterType);
-    virtual bool isClass(string* name);
     virtual bool openVarParameter(VarParameter* varParameter);
     virtual bool openThrowsClause(ThrowsClause* throwsClause);
     virtual bool openEnumMember(EnumMember* enumMember);
@@ -2,10 +2,11 @@
 using namespace scaly;
 namespace scalycpp {
 
-Lexer::Lexer(string* theText) {
+Lexer::Lexer(string* theText, Interner* theSymbols) {
     token = nullptr;
     whitespaceSkipped = true;
     text = theText;
+    symbols = theSymbols;
     end = text->getLength();
     position = 0;
     previousLine = 1;
@@ -57,7 +58,7 @@ void Lexer::advance() {
             {
                 if (token != nullptr)
                     token->_getPage()->clear();
-                token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) Punctuation(new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) string(c));
+                token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) Punctuation(symbols->intern(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage(), c));
                 position++;
                 column++;
             }
@@ -96,7 +97,7 @@ void Lexer::advance() {
                         default: {
                             if (token != nullptr)
                                 token->_getPage()->clear();
-                            token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) Punctuation(new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) string(c));
+                            token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) Punctuation(symbols->intern(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage(), c));
                         }
                     }
                 }
@@ -124,7 +125,7 @@ void Lexer::advance() {
                     else {
                         if (token != nullptr)
                             token->_getPage()->clear();
-                        token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) Punctuation(new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) string('.'));
+                        token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) Punctuation(symbols->intern(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage(), '.'));
                     }
                 }
             }
@@ -151,7 +152,7 @@ void Lexer::advance() {
                     else {
                         if (token != nullptr)
                             token->_getPage()->clear();
-                        token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) Punctuation(new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) string("->"));
+                        token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) Punctuation(symbols->intern(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage(), "->"));
                         position++;
                         column++;
                     }
@@ -167,7 +168,7 @@ void Lexer::advance() {
                 if (position == end) {
                     if (token != nullptr)
                         token->_getPage()->clear();
-                    token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) PostfixOperator(new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) string(c));
+                    token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) PostfixOperator(symbols->intern(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage(), c));
                 }
                 else {
                     switch (text->charAt(position)) {
@@ -194,7 +195,7 @@ void Lexer::advance() {
                                 else {
                                     if (token != nullptr)
                                         token->_getPage()->clear();
-                                    token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) Punctuation(new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) string(c));
+                                    token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) Punctuation(symbols->intern(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage(), c));
                                 }
                             }
                         }
@@ -229,7 +230,7 @@ void Lexer::advance() {
                         default: {
                             if (token != nullptr)
                                 token->_getPage()->clear();
-                            token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) Punctuation(new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) string("="));
+                            token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) Punctuation(symbols->intern(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage(), "="));
                         }
                     }
                 }
@@ -238,27 +239,46 @@ void Lexer::advance() {
         }
 
         default: {
-            if (token != nullptr)
-                token->_getPage()->clear();
-            token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) InvalidToken();
+            {
+                if (text->getIdentifierStartLength(position) > 0) {
+                    if (token != nullptr)
+                        token->_getPage()->clear();
+                    token = scanIdentifier(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage());
+                }
+                else {
+                    if (token != nullptr)
+                        token->_getPage()->clear();
+                    token = new(token == nullptr ? _getPage()->allocateExclusivePage() : token->_getPage()) InvalidToken();
+                }
+            }
         }
     }
 }
 
 Identifier* Lexer::scanIdentifier(_Page* _rp) {
     _Region _region; _Page* _p = _region.get();
-    char firstChar = text->charAt(position);
-    VarString* name = new(_p) VarString(firstChar);
+    VarString* name = new(_p) VarString();
     do {
-        position++;
-        column++;
         if (position == end)
-            return new(_rp) Identifier(new(_rp) string(name));
+            return new(_rp) Identifier(symbols->intern(_rp, name));
         char c = text->charAt(position);
-        if (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')) || (c == '_'))
+        if (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')) || (c == '_')) {
             name->append(c);
-        else
-            return new(_rp) Identifier(new(_rp) string(name));
+            position++;
+            column++;
+        }
+        else {
+            size_t bytes = text->getIdentifierPartLength(position);
+            if (bytes == 0)
+                return new(_rp) Identifier(symbols->intern(_rp, name));
+            column++;
+            do {
+                name->append(text->charAt(position));
+                position++;
+                bytes--;
+            }
+            while (bytes > 0);
+        }
     }
     while (true);
 }
@@ -282,9 +302,9 @@ Operator* Lexer::scanOperator(_Page* _rp, bool includeDots) {
         column++;
         if (position == end) {
             if (whitespaceSkippedBefore)
-                return new(_rp) BinaryOperator(new(_rp) string(operation));
+                return new(_rp) BinaryOperator(symbols->intern(_rp, operation));
             else
-                return new(_rp) PostfixOperator(new(_rp) string(operation));
+                return new(_rp) PostfixOperator(symbols->intern(_rp, operation));
         }
         if (includeDots && (text->charAt(position) == '.')) {
             operation->append(text->charAt(position));
@@ -319,11 +339,11 @@ Operator* Lexer::scanOperator(_Page* _rp, bool includeDots) {
                         }
                     }
                     if ((whitespaceSkippedBefore && whitespaceSkippedAfter) || (!whitespaceSkippedBefore && !whitespaceSkippedAfter))
-                        return new(_rp) BinaryOperator(new(_rp) string(operation));
+                        return new(_rp) BinaryOperator(symbols->intern(_rp, operation));
                     if ((!whitespaceSkippedBefore && whitespaceSkippedAfter))
-                        return new(_rp) PostfixOperator(new(_rp) string(operation));
+                        return new(_rp) PostfixOperator(symbols->intern(_rp, operation));
                     if ((whitespaceSkippedBefore && !whitespaceSkippedAfter))
-                        return new(_rp) PrefixOperator(new(_rp) string(operation));
+                        return new(_rp) PrefixOperator(symbols->intern(_rp, operation));
                 }
             }
         }
@@ -559,50 +579,16 @@ bool Lexer::skipWhitespace() {
 }
 
 void Lexer::handleSingleLineComment() {
-    do {
-        if (position == end)
-            return;
-        switch (text->charAt(position)) {
-            case '\t': {
-                {
-                    whitespaceSkipped = true;
-                    position++;
-                    column += 4;
-                    continue;
-                }
-                break;
-            }
-
-            case '\r': {
-                {
-                    whitespaceSkipped = true;
-                    position++;
-                    continue;
-                }
-                break;
-            }
-
-            case '\n': {
-                {
-                    whitespaceSkipped = true;
-                    position++;
-                    column = 1;
-                    line++;
-                    return;
-                }
-                break;
-            }
-
-            default: {
-                {
-                    position++;
-                    column++;
-                    continue;
-                }
-            }
-        }
+    size_t start = position;
+    position = text->find('\n', position);
+    whitespaceSkipped = true;
+    if (position == end) {
+        column += end - start;
+        return;
     }
-    while (true);
+    position++;
+    column = 1;
+    line++;
 }
 
 void Lexer::handleMultiLineComment() {
@@ -689,28 +675,28 @@ bool Lexer::parseKeyword(string* fixedString) {
     if (!(token->_isIdentifier()))
         return false;
     Identifier* identifier = (Identifier*)token;
-    return identifier->name->equals(fixedString);
+    return identifier->name == fixedString;
 }
 
 string* Lexer::parseIdentifier(_Page* _rp) {
     if (!(token->_isIdentifier()))
         return nullptr;
     Identifier* identifier = (Identifier*)token;
-    return new(_rp) string(identifier->name);
+    return identifier->name;
 }
 
 bool Lexer::parsePunctuation(string* fixedString) {
     if (!(token->_isPunctuation()))
         return false;
     Punctuation* punctuation = (Punctuation*)token;
-    return punctuation->sign->equals(fixedString);
+    return punctuation->sign == fixedString;
 }
 
 string* Lexer::parseOperator(_Page* _rp) {
     if (!(token->_isOperator()))
         return nullptr;
     Operator* op = (Operator*)token;
-    return new(_rp) string(op->operation);
+    return op->operation;
 }
 
 Literal* Lexer::parseLiteral(_Page* _rp) {
@@ -735,26 +721,26 @@ string* Lexer::parsePrefixOperator(_Page* _rp) {
     if (!(token->_isPrefixOperator()))
         return nullptr;
     Operator* op = (Operator*)token;
-    return new(_rp) string(op->operation);
+    return op->operation;
 }
 
 string* Lexer::parseBinaryOperator(_Page* _rp) {
     if (!(token->_isBinaryOperator())) {
         if ((token->_isPunctuation()) && ((((Punctuation*)token)->sign->equals("<")) || (((Punctuation*)token)->sign->equals(">")))) {
             Operator* op = (Operator*)token;
-            return new(_rp) string(op->operation);
+            return op->operation;
         }
         return nullptr;
     }
     Operator* op = (Operator*)token;
-    return new(_rp) string(op->operation);
+    return op->operation;
 }
 
 string* Lexer::parsePostfixOperator(_Page* _rp) {
     if (!(token->_isPostfixOperator()))
         return nullptr;
     Operator* op = (Operator*)token;
-    return new(_rp) string(op->operation);
+    return op->operation;
 }
 
 bool Lexer::isAtEnd() {
@@ -36,12 +36,13 @@ class Lexer : public Object {
 public:
     Token* token; bool whitespaceSkipped;
     string* text;
+    Interner* symbols;
     size_t position;
     size_t end;
     size_t previousLine; size_t previousColumn;
     size_t line;
     size_t column;
-    Lexer(string* theText);
+    Lexer(string* theText, Interner* theSymbols);
     virtual void advance();
     virtual Identifier* scanIdentifier(_Page* _rp);
     virtual Operator* scanOperator(_Page* _rp, bool includeDots);
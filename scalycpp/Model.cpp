@@ -43,8 +43,6 @@ bool ModelVisitor::openProgram(Program* program) {
 
 bool ModelVisitor::openModule(Module* module) {
     if (isTopLevelFile(module)) {
-        if (model != nullptr)
-            model->_getPage()->clear();
         model->main = new(model == nullptr ? _getPage()->allocateExclusivePage() : model->_getPage()) Scope(nullptr);
     }
     else {
@@ -26,7 +26,7 @@ _Result<Options, OptionsError> Options::parseArguments(_Page* _rp, _Page* _ep, _
                 {
                     i++;
                     if (i == length)
-                        return _Result<Options, OptionsError>(new(_ep) OptionsError(new(_ep) _OptionsError_invalidOption(*(*args)[i - 1])));
+                        return _Result<Options, OptionsError>(OptionsError(_OptionsError_invalidOption(*(*args)[i - 1])));
                     else
                         output = *(*args)[i];
                 }
@@ -37,7 +37,7 @@ _Result<Options, OptionsError> Options::parseArguments(_Page* _rp, _Page* _ep, _
                 {
                     i++;
                     if (i == length)
-                        return _Result<Options, OptionsError>(new(_ep) OptionsError(new(_ep) _OptionsError_invalidOption(*(*args)[i - 1])));
+                        return _Result<Options, OptionsError>(OptionsError(_OptionsError_invalidOption(*(*args)[i - 1])));
                     else
                         dir = *(*args)[i];
                 }
@@ -45,15 +45,15 @@ _Result<Options, OptionsError> Options::parseArguments(_Page* _rp, _Page* _ep, _
             }
 
             default: {
-                return _Result<Options, OptionsError>(new(_ep) OptionsError(new(_ep) _OptionsError_unknownOption(*(*args)[i])));
+                return _Result<Options, OptionsError>(OptionsError(_OptionsError_unknownOption(*(*args)[i])));
             }
         }
         i++;
     }
     if (output == nullptr)
-        return _Result<Options, OptionsError>(new(_ep) OptionsError(_OptionsErrorCode_noOutputOption));
+        return _Result<Options, OptionsError>(OptionsError(_OptionsErrorCode_noOutputOption));
     if (input->length() == 0)
-        return _Result<Options, OptionsError>(new(_ep) OptionsError(_OptionsErrorCode_noFilesToCompile));
+        return _Result<Options, OptionsError>(OptionsError(_OptionsErrorCode_noFilesToCompile));
     return _Result<Options, OptionsError>(new(_rp) Options(new(_rp) _Array<string>(input), output, dir));
 }
 
@@ -29,23 +29,25 @@ enum _OptionsErrorCode {
 class OptionsError : public Object {
 public:
     OptionsError(_OptionsErrorCode errorCode)
-    : errorCode(errorCode), errorInfo(0) {}
+    : errorCode(errorCode) {}
 
-    OptionsError(_OptionsError_invalidOption* invalidOption)
-    : errorCode(_OptionsErrorCode_invalidOption), errorInfo(invalidOption) {}
+    OptionsError(_OptionsError_invalidOption invalidOption)
+    : errorCode(_OptionsErrorCode_invalidOption), invalidOption(invalidOption) {}
 
-    OptionsError(_OptionsError_unknownOption* unknownOption)
-    : errorCode(_OptionsErrorCode_unknownOption), errorInfo(unknownOption) {}
+    OptionsError(_OptionsError_unknownOption unknownOption)
+    : errorCode(_OptionsErrorCode_unknownOption), unknownOption(unknownOption) {}
 
     long _getErrorCode();
-    void* _getErrorInfo();
 
     _OptionsError_invalidOption* get_invalidOption();
     _OptionsError_unknownOption* get_unknownOption();
 
 private:
     _OptionsErrorCode errorCode;
-    void* errorInfo;
+    union {
+        _OptionsError_invalidOption invalidOption;
+        _OptionsError_unknownOption unknownOption;
+    };
 };
 
 class ParserError;
@@ -64,19 +66,20 @@ enum _ParserErrorCode {
 class ParserError : public Object {
 public:
     ParserError(_ParserErrorCode errorCode)
-    : errorCode(errorCode), errorInfo(0) {}
+    : errorCode(errorCode) {}
 
-    ParserError(_ParserError_syntax* syntax)
-    : errorCode(_ParserErrorCode_syntax), errorInfo(syntax) {}
+    ParserError(_ParserError_syntax syntax)
+    : errorCode(_ParserErrorCode_syntax), syntax(syntax) {}
 
     long _getErrorCode();
-    void* _getErrorInfo();
 
     _ParserError_syntax* get_syntax();
 
 private:
     _ParserErrorCode errorCode;
-    void* errorInfo;
+    union {
+        _ParserError_syntax syntax;
+    };
 };
 
 class CompilerError;
@@ -95,19 +98,20 @@ enum _CompilerErrorCode {
 class CompilerError : public Object {
 public:
     CompilerError(_CompilerErrorCode errorCode)
-    : errorCode(errorCode), errorInfo(0) {}
+    : errorCode(errorCode) {}
 
-    CompilerError(_CompilerError_parser* parser)
-    : errorCode(_CompilerErrorCode_parser), errorInfo(parser) {}
+    CompilerError(_CompilerError_parser parser)
+    : errorCode(_CompilerErrorCode_parser), parser(parser) {}
 
     long _getErrorCode();
-    void* _getErrorInfo();
 
     _CompilerError_parser* get_parser();
 
 private:
     _CompilerErrorCode errorCode;
-    void* errorInfo;
+    union {
+        _CompilerError_parser parser;
+    };
 };
 
 }
@@ -2,52 +2,52 @@
 using namespace scaly;
 namespace scalycpp {
 
-Parser::Parser(string* theFileName, string* text) {
-    lexer = new(_getPage()->allocateExclusivePage()) Lexer(text);
+Parser::Parser(string* theFileName, string* text, Interner* symbols) {
+    lexer = new(_getPage()->allocateExclusivePage()) Lexer(text, symbols);
     fileName = theFileName;
-    classKeyword = new(_getPage()) string("class");
-    functionKeyword = new(_getPage()) string("function");
-    ifKeyword = new(_getPage()) string("if");
-    elseKeyword = new(_getPage()) string("else");
-    switchKeyword = new(_getPage()) string("switch");
-    caseKeyword = new(_getPage()) string("case");
-    defaultKeyword = new(_getPage()) string("default");
-    catchKeyword = new(_getPage()) string("catch");
-    forKeyword = new(_getPage()) string("for");
-    inKeyword = new(_getPage()) string("in");
-    whileKeyword = new(_getPage()) string("while");
-    doKeyword = new(_getPage()) string("do");
-    returnKeyword = new(_getPage()) string("return");
-    throwKeyword = new(_getPage()) string("throw");
-    breakKeyword = new(_getPage()) string("break");
-    throwsKeyword = new(_getPage()) string("throws");
-    staticKeyword = new(_getPage()) string("static");
-    letKeyword = new(_getPage()) string("let");
-    mutableKeyword = new(_getPage()) string("mutable");
-    isKeyword = new(_getPage()) string("is");
-    asKeyword = new(_getPage()) string("as");
-    constructorKeyword = new(_getPage()) string("constructor");
-    enumKeyword = new(_getPage()) string("enum");
-    thisKeyword = new(_getPage()) string("this");
-    nullKeyword = new(_getPage()) string("null");
-    newKeyword = new(_getPage()) string("new");
-    extendsKeyword = new(_getPage()) string("extends");
-    equal = new(_getPage()) string("=");
-    comma = new(_getPage()) string(",");
-    leftParen = new(_getPage()) string("(");
-    rightParen = new(_getPage()) string(")");
-    leftCurly = new(_getPage()) string("{");
-    rightCurly = new(_getPage()) string("}");
-    leftBracket = new(_getPage()) string("[");
-    rightBracket = new(_getPage()) string("]");
-    colon = new(_getPage()) string(":");
-    dot = new(_getPage()) string(".");
-    underscore = new(_getPage()) string("_");
-    circumflex = new(_getPage()) string("^");
-    dollar = new(_getPage()) string("$");
-    at = new(_getPage()) string("@");
-    hash = new(_getPage()) string("#");
-    ampersand = new(_getPage()) string("&");
+    classKeyword = symbols->intern(_getPage(), "class");
+    functionKeyword = symbols->intern(_getPage(), "function");
+    ifKeyword = symbols->intern(_getPage(), "if");
+    elseKeyword = symbols->intern(_getPage(), "else");
+    switchKeyword = symbols->intern(_getPage(), "switch");
+    caseKeyword = symbols->intern(_getPage(), "case");
+    defaultKeyword = symbols->intern(_getPage(), "default");
+    catchKeyword = symbols->intern(_getPage(), "catch");
+    forKeyword = symbols->intern(_getPage(), "for");
+    inKeyword = symbols->intern(_getPage(), "in");
+    whileKeyword = symbols->intern(_getPage(), "while");
+    doKeyword = symbols->intern(_getPage(), "do");
+    returnKeyword = symbols->intern(_getPage(), "return");
+    throwKeyword = symbols->intern(_getPage(), "throw");
+    breakKeyword = symbols->intern(_getPage(), "break");
+    throwsKeyword = symbols->intern(_getPage(), "throws");
+    staticKeyword = symbols->intern(_getPage(), "static");
+    letKeyword = symbols->intern(_getPage(), "let");
+    mutableKeyword = symbols->intern(_getPage(), "mutable");
+    isKeyword = symbols->intern(_getPage(), "is");
+    asKeyword = symbols->intern(_getPage(), "as");
+    constructorKeyword = symbols->intern(_getPage(), "constructor");
+    enumKeyword = symbols->intern(_getPage(), "enum");
+    thisKeyword = symbols->intern(_getPage(), "this");
+    nullKeyword = symbols->intern(_getPage(), "null");
+    newKeyword = symbols->intern(_getPage(), "new");
+    extendsKeyword = symbols->intern(_getPage(), "extends");
+    equal = symbols->intern(_getPage(), "=");
+    comma = symbols->intern(_getPage(), ",");
+    leftParen = symbols->intern(_getPage(), "(");
+    rightParen = symbols->intern(_getPage(), ")");
+    leftCurly = symbols->intern(_getPage(), "{");
+    rightCurly = symbols->intern(_getPage(), "}");
+    leftBracket = symbols->intern(_getPage(), "[");
+    rightBracket = symbols->intern(_getPage(), "]");
+    colon = symbols->intern(_getPage(), ":");
+    dot = symbols->intern(_getPage(), ".");
+    underscore = symbols->intern(_getPage(), "_");
+    circumflex = symbols->intern(_getPage(), "^");
+    dollar = symbols->intern(_getPage(), "$");
+    at = symbols->intern(_getPage(), "@");
+    hash = symbols->intern(_getPage(), "#");
+    ampersand = symbols->intern(_getPage(), "&");
 }
 
 _Result<Module, ParserError> Parser::parseModule(_Page* _rp, _Page* _ep) {
@@ -58,7 +58,7 @@ _Result<Module, ParserError> Parser::parseModule(_Page* _rp, _Page* _ep) {
         if (!isAtEnd()) {
             _Region _region; _Page* _p = _region.get();
             Position* errorPos = lexer->getPreviousPosition(_p);
-            return _Result<Module, ParserError>(new(_ep) ParserError(new(_ep) _ParserError_syntax(errorPos->line, errorPos->column)));
+            return _Result<Module, ParserError>(ParserError(_ParserError_syntax(errorPos->line, errorPos->column)));
         }
     }
     Position* end = lexer->getPosition(_p);
@@ -82,7 +82,7 @@ _Array<Statement>* Parser::parseStatementList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<Statement>();
+            ret = new(_p) _Array<Statement>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<Statement>(ret) : nullptr;
@@ -199,7 +199,7 @@ _Array<IdentifierInitializer>* Parser::parseIdentifierInitializerList(_Page* _rp
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<IdentifierInitializer>();
+            ret = new(_p) _Array<IdentifierInitializer>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<IdentifierInitializer>(ret) : nullptr;
@@ -245,7 +245,7 @@ _Array<AdditionalInitializer>* Parser::parseAdditionalInitializerList(_Page* _rp
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<AdditionalInitializer>();
+            ret = new(_p) _Array<AdditionalInitializer>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<AdditionalInitializer>(ret) : nullptr;
@@ -358,7 +358,7 @@ _Array<TypePostfix>* Parser::parseTypePostfixList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<TypePostfix>();
+            ret = new(_p) _Array<TypePostfix>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<TypePostfix>(ret) : nullptr;
@@ -538,7 +538,7 @@ _Array<Modifier>* Parser::parseModifierList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<Modifier>();
+            ret = new(_p) _Array<Modifier>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<Modifier>(ret) : nullptr;
@@ -592,7 +592,7 @@ _Array<ParameterClause>* Parser::parseParameterClauseList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<ParameterClause>();
+            ret = new(_p) _Array<ParameterClause>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<ParameterClause>(ret) : nullptr;
@@ -633,7 +633,7 @@ _Array<Parameter>* Parser::parseParameterList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<Parameter>();
+            ret = new(_p) _Array<Parameter>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<Parameter>(ret) : nullptr;
@@ -790,7 +790,7 @@ _Array<EnumMember>* Parser::parseEnumMemberList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<EnumMember>();
+            ret = new(_p) _Array<EnumMember>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<EnumMember>(ret) : nullptr;
@@ -846,7 +846,7 @@ _Array<AdditionalCase>* Parser::parseAdditionalCaseList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<AdditionalCase>();
+            ret = new(_p) _Array<AdditionalCase>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<AdditionalCase>(ret) : nullptr;
@@ -923,7 +923,7 @@ _Array<Inheritance>* Parser::parseInheritanceList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<Inheritance>();
+            ret = new(_p) _Array<Inheritance>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<Inheritance>(ret) : nullptr;
@@ -979,7 +979,7 @@ _Array<ClassMember>* Parser::parseClassMemberList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<ClassMember>();
+            ret = new(_p) _Array<ClassMember>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<ClassMember>(ret) : nullptr;
@@ -1344,7 +1344,7 @@ _Array<SwitchCase>* Parser::parseSwitchCaseList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<SwitchCase>();
+            ret = new(_p) _Array<SwitchCase>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<SwitchCase>(ret) : nullptr;
@@ -1437,7 +1437,7 @@ _Array<CaseItem>* Parser::parseCaseItemList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<CaseItem>();
+            ret = new(_p) _Array<CaseItem>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<CaseItem>(ret) : nullptr;
@@ -1589,7 +1589,7 @@ _Array<ExpressionElement>* Parser::parseExpressionElementList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<ExpressionElement>();
+            ret = new(_p) _Array<ExpressionElement>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<ExpressionElement>(ret) : nullptr;
@@ -1726,7 +1726,7 @@ _Array<Postfix>* Parser::parsePostfixList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<Postfix>();
+            ret = new(_p) _Array<Postfix>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<Postfix>(ret) : nullptr;
@@ -1798,7 +1798,7 @@ _Array<CatchClause>* Parser::parseCatchClauseList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<CatchClause>();
+            ret = new(_p) _Array<CatchClause>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<CatchClause>(ret) : nullptr;
@@ -1918,7 +1918,7 @@ _Array<TuplePatternElement>* Parser::parseTuplePatternElementList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<TuplePatternElement>();
+            ret = new(_p) _Array<TuplePatternElement>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<TuplePatternElement>(ret) : nullptr;
@@ -2004,7 +2004,7 @@ _Array<BinaryExpression>* Parser::parseBinaryExpressionList(_Page* _rp) {
         if (node == nullptr)
             break;
         if (ret == nullptr)
-            ret = new(_p) _Array<BinaryExpression>();
+            ret = new(_p) _Array<BinaryExpression>(8);
         ret->push(node);
     }
     return ret ? new(_rp) _Array<BinaryExpression>(ret) : nullptr;
@@ -188,7 +188,7 @@ class TypeCast;
 
 class Parser : public Object {
 public:
-    Parser(string* theFileName, string* text);
+    Parser(string* theFileName, string* text, Interner* symbols);
     virtual _Result<Module, ParserError> parseModule(_Page* _rp, _Page* _ep);
     virtual _Array<Statement>* parseStatementList(_Page* _rp);
     virtual Statement* parseStatement(_Page* _rp);
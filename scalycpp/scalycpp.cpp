@@ -55,7 +55,8 @@ FileError* _main(_Page* _ep,  _Array<string>* arguments) {
         options = _options_result.getResult();
     }
     else if (_options_result._getErrorCode() == _OptionsErrorCode_invalidOption) {
-        string* option = _options_result.getError()->get_invalidOption()->option;
+        auto _payload = _options_result.getError()->get_invalidOption();
+        string* option = _payload->option;
         {
             _Region _region; _Page* _p = _region.get();
             VarString* msg = new(_p) VarString("Invalid option ");
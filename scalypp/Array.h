@@ -43,13 +43,26 @@ public:
         }
         else {
             if (_size == _capacity)
-                reAllocate(_capacity * 2);
+                reAllocate(_capacity ? _capacity * 2 : 1);
         }
 
         *(_rawArray + _size) = item;
         _size += 1;
     }
 
+    // Make room for at least capacity items
+    void reserve(size_t capacity) {
+        if (!_rawArray) {
+            _capacity = capacity;
+            _size = 0;
+            allocate();
+        }
+        else {
+            if (capacity > _capacity)
+                reAllocate(capacity);
+        }
+    }
+
     // Take away a value from the array's end
     T* pop() {
         if (!_size) {
@@ -77,6 +90,12 @@ public:
 private:
 
     void reAllocate(size_t newCapacity) {
+        // Try to extend the raw array in place if it was the last thing allocated on its page
+        if (_Page::getPage(_rawArray)->extend(_rawArray + _capacity, (newCapacity - _capacity) * sizeof(T*))) {
+            _capacity = newCapacity;
+            return;
+        }
+
         T** oldArray = _rawArray;
         _capacity = newCapacity;
         allocate();
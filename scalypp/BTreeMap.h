@@ -0,0 +1,315 @@
+#ifndef __Scaly__BTreeMap__
+#define __Scaly__BTreeMap__
+#include "Scaly.h"
+namespace scaly {
+
+// An ordered map keyed by strings, as a B-tree whose nodes hold up to eight entries.
+// The first eight bytes of each key are kept in the node as a number, so that
+// searching a node mostly compares numbers in one cache line instead of following
+// a pointer to each key. Keys compare like memcmp, the shorter one first on a tie.
+// K has to provide getNativeString and getLength like string and VarString do.
+template<class K, class V> class _BTreeMap : public Object {
+public:
+    _BTreeMap<K, V>()
+    : _size(0), _height(0), _root(0) {}
+
+    // A map of the keys, which have to be sorted and unique, and the values at the same positions
+    _BTreeMap<K, V>(_Array<K>* keys, _Array<V>* values)
+    : _size(keys->length()), _height(0), _root(0) {
+        if (!_size)
+            return;
+
+        while (capacity(_height) < _size)
+            _height++;
+        _root = build(keys->getRawArray(), values->getRawArray(), _size, _height);
+    }
+
+    size_t length() {
+        return _size;
+    }
+
+    // Insert or replace the value of a key. Returns false if the key was already present.
+    bool insert(K* key, V* value) {
+        _Probe probe = probeOf(key->getNativeString(), key->getLength());
+        if (!_root)
+            _root = allocateNode(true);
+
+        // Full nodes are split on the way down, so there is always room for the entry
+        if (_root->count == order) {
+            _Node* root = allocateNode(false);
+            root->children[0] = _root;
+            splitChild(root, 0, _height);
+            _root = root;
+            _height++;
+        }
+
+        _Node* node = _root;
+        for (size_t level = _height;; level--) {
+            bool found;
+            size_t i = search(node, probe, &found);
+            if (found) {
+                node->values[i] = value;
+                return false;
+            }
+
+            if (!level) {
+                insertAt(node, i, probe.prefix, key, value, 0);
+                _size++;
+                return true;
+            }
+
+            if (node->children[i]->count == order) {
+                splitChild(node, i, level - 1);
+                // The middle entry of the child moved up to i
+                int comparison = compare(probe, node, i);
+                if (!comparison) {
+                    node->values[i] = value;
+                    return false;
+                }
+                if (comparison > 0)
+                    i++;
+            }
+
+            node = node->children[i];
+        }
+    }
+
+    // The value of a key, or 0 if it is not present
+    V* get(K* key) {
+        return get(key->getNativeString(), key->getLength());
+    }
+
+    // The value of the key spelled by length bytes at data, or 0 if it is not present
+    V* get(const char* data, size_t length) {
+        _Probe probe = probeOf(data, length);
+        _Node* node = _root;
+        for (size_t level = _height; node; level--) {
+            bool found;
+            size_t i = search(node, probe, &found);
+            if (found)
+                return node->values[i];
+            if (!level)
+                break;
+            node = node->children[i];
+        }
+
+        return 0;
+    }
+
+    bool contains(K* key) {
+        _Probe probe = probeOf(key->getNativeString(), key->getLength());
+        _Node* node = _root;
+        for (size_t level = _height; node; level--) {
+            bool found;
+            size_t i = search(node, probe, &found);
+            if (found)
+                return true;
+            if (!level)
+                break;
+            node = node->children[i];
+        }
+
+        return false;
+    }
+
+    // Calls f with each key and its value in ascending order of the keys
+    template<class F> void forEach(F f) {
+        if (_root)
+            visit(_root, _height, 0, 0, f);
+    }
+
+    // Calls f with each key from from up to but not including to, and its value.
+    // A bound of 0 leaves that end of the range open.
+    template<class F> void forEachInRange(K* from, K* to, F f) {
+        if (!_root)
+            return;
+
+        _Probe fromProbe;
+        _Probe toProbe;
+        if (from)
+            fromProbe = probeOf(from->getNativeString(), from->getLength());
+        if (to)
+            toProbe = probeOf(to->getNativeString(), to->getLength());
+        visit(_root, _height, from ? &fromProbe : 0, to ? &toProbe : 0, f);
+    }
+
+private:
+    // The prefixes of a full node fill one cache line
+    static const size_t order = _cacheLineSize / sizeof(uint64_t);
+
+    // Leaves are allocated without the children
+    struct _Node {
+        uint64_t prefixes[order];
+        K* keys[order];
+        V* values[order];
+        size_t count;
+        _Node* children[order + 1];
+    };
+
+    // A key being searched for, with its prefix
+    struct _Probe {
+        const char* data;
+        size_t length;
+        uint64_t prefix;
+    };
+
+    // The first eight bytes of a key, padded with zeros, as a number which sorts like them
+    static uint64_t prefixOf(const char* data, size_t length) {
+        uint64_t prefix = 0;
+        size_t bytes = length < sizeof(uint64_t) ? length : sizeof(uint64_t);
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        memcpy(&prefix, data, bytes);
+        return __builtin_bswap64(prefix);
+#else
+        for (size_t i = 0; i < bytes; i++)
+            prefix |= (uint64_t)(unsigned char)data[i] << (56 - 8 * i);
+        return prefix;
+#endif
+    }
+
+    static _Probe probeOf(const char* data, size_t length) {
+        _Probe probe = { data, length, prefixOf(data, length) };
+        return probe;
+    }
+
+    // Less than, equal to or greater than zero as probe is less than, equal to or greater than the key at i
+    static int compare(_Probe& probe, _Node* node, size_t i) {
+        if (probe.prefix != node->prefixes[i])
+            return probe.prefix < node->prefixes[i] ? -1 : 1;
+
+        // The prefixes are equal, so only the bytes after them are left to compare
+        K* key = node->keys[i];
+        size_t length = key->getLength();
+        size_t shorter = probe.length < length ? probe.length : length;
+        if (shorter > sizeof(uint64_t)) {
+            int comparison = memcmp(probe.data + sizeof(uint64_t), key->getNativeString() + sizeof(uint64_t), shorter - sizeof(uint64_t));
+            if (comparison)
+                return comparison;
+        }
+
+        return probe.length < length ? -1 : probe.length > length ? 1 : 0;
+    }
+
+    // The position of the first key in node which is not less than probe, and whether it is equal
+    static size_t search(_Node* node, _Probe& probe, bool* found) {
+        size_t i = 0;
+        while (i < node->count && probe.prefix > node->prefixes[i])
+            i++;
+
+        for (; i < node->count; i++) {
+            int comparison = compare(probe, node, i);
+            if (comparison <= 0) {
+                *found = !comparison;
+                return i;
+            }
+        }
+
+        *found = false;
+        return i;
+    }
+
+    // The number of entries a tree of nodes down to level can hold
+    static size_t capacity(size_t level) {
+        return level ? order + (order + 1) * capacity(level - 1) : order;
+    }
+
+    _Node* allocateNode(bool leaf) {
+        size_t size = leaf ? sizeof(_Node) - sizeof(_Node*) * (order + 1) : sizeof(_Node);
+        _Node* node = (_Node*)alignToCacheLine((char*)_getPage()->allocateObject(size + _cacheLineSize - _alignment));
+        node->count = 0;
+        return node;
+    }
+
+    // Puts the entry at i, and child right of it if the node is not a leaf
+    static void insertAt(_Node* node, size_t i, uint64_t prefix, K* key, V* value, _Node* child) {
+        size_t moved = node->count - i;
+        memmove(node->prefixes + i + 1, node->prefixes + i, moved * sizeof(uint64_t));
+        memmove(node->keys + i + 1, node->keys + i, moved * sizeof(K*));
+        memmove(node->values + i + 1, node->values + i, moved * sizeof(V*));
+        node->prefixes[i] = prefix;
+        node->keys[i] = key;
+        node->values[i] = value;
+        if (child) {
+            memmove(node->children + i + 2, node->children + i + 1, moved * sizeof(_Node*));
+            node->children[i + 1] = child;
+        }
+        node->count++;
+    }
+
+    // Moves the upper half of the full child at i into a new node and its middle entry up into parent
+    void splitChild(_Node* parent, size_t i, size_t level) {
+        const size_t middle = order / 2;
+        _Node* child = parent->children[i];
+        _Node* right = allocateNode(!level);
+        right->count = order - middle - 1;
+        memcpy(right->prefixes, child->prefixes + middle + 1, right->count * sizeof(uint64_t));
+        memcpy(right->keys, child->keys + middle + 1, right->count * sizeof(K*));
+        memcpy(right->values, child->values + middle + 1, right->count * sizeof(V*));
+        if (level)
+            memcpy(right->children, child->children + middle + 1, (right->count + 1) * sizeof(_Node*));
+        child->count = middle;
+        insertAt(parent, i, child->prefixes[middle], child->keys[middle], child->values[middle], right);
+    }
+
+    // A tree of nodes down to level holding count entries, with the entries spread
+    // evenly over the children so that no node ends up with less than half of them
+    _Node* build(K** keys, V** values, size_t count, size_t level) {
+        _Node* node = allocateNode(!level);
+        if (!level) {
+            for (size_t i = 0; i < count; i++)
+                node->prefixes[i] = prefixOf(keys[i]->getNativeString(), keys[i]->getLength());
+            memcpy(node->keys, keys, count * sizeof(K*));
+            memcpy(node->values, values, count * sizeof(V*));
+            node->count = count;
+            return node;
+        }
+
+        size_t below = capacity(level - 1);
+        size_t children = (count + below + 1) / (below + 1);
+        size_t rest = count - (children - 1);
+        for (size_t c = 0; c < children; c++) {
+            size_t share = rest / children + (c < rest % children ? 1 : 0);
+            node->children[c] = build(keys, values, share, level - 1);
+            keys += share;
+            values += share;
+            if (c + 1 < children) {
+                node->prefixes[c] = prefixOf((*keys)->getNativeString(), (*keys)->getLength());
+                node->keys[c] = *keys++;
+                node->values[c] = *values++;
+            }
+        }
+
+        node->count = children - 1;
+        return node;
+    }
+
+    // Calls f with the entries of node not less than from until one is not less than to.
+    // Returns false once to is reached.
+    template<class F> static bool visit(_Node* node, size_t level, _Probe* from, _Probe* to, F& f) {
+        size_t i = 0;
+        bool found = false;
+        if (from)
+            i = search(node, *from, &found);
+
+        // If from is in this node, the child left of it holds only smaller keys
+        if (level && !found && !visit(node->children[i], level - 1, from, to, f))
+            return false;
+
+        for (; i < node->count; i++) {
+            if (to && compare(*to, node, i) <= 0)
+                return false;
+            f(node->keys[i], node->values[i]);
+            if (level && !visit(node->children[i + 1], level - 1, 0, to, f))
+                return false;
+        }
+
+        return true;
+    }
+
+    size_t _size;
+    size_t _height;
+    _Node* _root;
+};
+
+}
+#endif//__Scaly__BTreeMap__
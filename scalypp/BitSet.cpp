@@ -0,0 +1,131 @@
+#include "Scaly.h"
+namespace scaly {
+
+#if defined(__GNUC__) && defined(__x86_64__)
+
+__attribute__((target("popcnt")))
+static size_t countBitsPopcnt(const size_t* words, size_t length) {
+    size_t count = 0;
+    for (size_t i = 0; i < length; i++)
+        count += __builtin_popcountl(words[i]);
+    return count;
+}
+
+// Detected on first use; the initialization of a local static is thread safe
+static bool hasPopcnt() {
+    static const bool popcnt = (__builtin_cpu_init(), __builtin_cpu_supports("popcnt"));
+    return popcnt;
+}
+
+size_t _countBits(const size_t* words, size_t length) {
+    if (hasPopcnt())
+        return countBitsPopcnt(words, length);
+
+    size_t count = 0;
+    for (size_t i = 0; i < length; i++)
+        count += _popCount(words[i]);
+    return count;
+}
+
+#else
+
+size_t _countBits(const size_t* words, size_t length) {
+    size_t count = 0;
+    for (size_t i = 0; i < length; i++)
+        count += _popCount(words[i]);
+    return count;
+}
+
+#endif
+
+_BitSet::_BitSet(size_t size)
+: size(size), length((size + bitsInWord - 1) / bitsInWord) {
+    words = (size_t*)_getPage()->allocateObject(length * sizeof(size_t));
+    memset(words, 0, length * sizeof(size_t));
+}
+
+_BitSet::_BitSet(_BitSet* bitSet)
+: size(bitSet->size), length(bitSet->length) {
+    words = (size_t*)_getPage()->allocateObject(length * sizeof(size_t));
+    memcpy(words, bitSet->words, length * sizeof(size_t));
+}
+
+void _BitSet::addAll() {
+    memset(words, 0xff, length * sizeof(size_t));
+    trim();
+}
+
+void _BitSet::removeAll() {
+    memset(words, 0, length * sizeof(size_t));
+}
+
+void _BitSet::unionWith(_BitSet* other) {
+    for (size_t i = 0; i < length; i++)
+        words[i] |= other->words[i];
+}
+
+void _BitSet::intersectWith(_BitSet* other) {
+    for (size_t i = 0; i < length; i++)
+        words[i] &= other->words[i];
+}
+
+void _BitSet::subtract(_BitSet* other) {
+    for (size_t i = 0; i < length; i++)
+        words[i] &= ~other->words[i];
+}
+
+bool _BitSet::isEmpty() {
+    for (size_t i = 0; i < length; i++) {
+        if (words[i])
+            return false;
+    }
+    return true;
+}
+
+bool _BitSet::equals(_BitSet* other) {
+    return size == other->size && !memcmp(words, other->words, length * sizeof(size_t));
+}
+
+size_t _BitSet::count() {
+    return _countBits(words, length);
+}
+
+size_t _BitSet::findFirst(size_t start) {
+    if (start >= size)
+        return notFound;
+
+    size_t i = start / bitsInWord;
+    // Mask the bits below start in the first word
+    size_t word = words[i] & (~(size_t)0 << (start % bitsInWord));
+    while (!word) {
+        if (++i == length)
+            return notFound;
+        word = words[i];
+    }
+    return i * bitsInWord + _lowestSetBit(word);
+}
+
+size_t _BitSet::findFirstMissing(size_t start) {
+    if (start >= size)
+        return notFound;
+
+    size_t i = start / bitsInWord;
+    size_t word = ~words[i] & (~(size_t)0 << (start % bitsInWord));
+    while (!word) {
+        if (++i == length)
+            return notFound;
+        word = ~words[i];
+    }
+
+    // The bits beyond size are clear, so they have to be ruled out
+    size_t found = i * bitsInWord + _lowestSetBit(word);
+    return found < size ? found : notFound;
+}
+
+void _BitSet::trim() {
+    size_t rest = size % bitsInWord;
+    if (rest)
+        words[length - 1] &= ((size_t)1 << rest) - 1;
+}
+
+}
@@ -0,0 +1,100 @@
+#ifndef __Scaly__BitSet__
+#define __Scaly__BitSet__
+#include "Scaly.h"
+namespace scaly {
+
+// Word kernels, which the compiler turns into single instructions where the CPU has them
+
+// The number of set bits in word
+inline size_t _popCount(size_t word) {
+#if defined(__GNUC__)
+    return __builtin_popcountl(word);
+#else
+    size_t count = 0;
+    for (; word; word &= word - 1)
+        count++;
+    return count;
+#endif
+}
+
+// The position of the lowest set bit in word, which must not be 0
+inline size_t _lowestSetBit(size_t word) {
+#if defined(__GNUC__)
+    return __builtin_ctzl(word);
+#else
+    size_t position = 0;
+    for (; !(word & 1); word >>= 1)
+        position++;
+    return position;
+#endif
+}
+
+// The number of set bits in length words at words. Uses popcnt if the CPU has it.
+size_t _countBits(const size_t* words, size_t length);
+
+// A fixed number of bits on the page of the set, e.g., the members of a set of
+// classes or the allocated pages of a chunk. The operations on whole sets work
+// a word at a time, and those on other sets expect them to have the same size.
+class _BitSet : public Object {
+public:
+    static const size_t notFound = (size_t)-1;
+    static const size_t bitsInWord = 8 * sizeof(size_t);
+
+    // A set of size bits which are all clear
+    _BitSet(size_t size);
+    _BitSet(_BitSet* bitSet);
+
+    size_t getSize() {
+        return size;
+    }
+
+    bool contains(size_t i) {
+        return (words[i / bitsInWord] >> (i % bitsInWord)) & 1;
+    }
+
+    void add(size_t i) {
+        words[i / bitsInWord] |= (size_t)1 << (i % bitsInWord);
+    }
+
+    void remove(size_t i) {
+        words[i / bitsInWord] &= ~((size_t)1 << (i % bitsInWord));
+    }
+
+    // The bits from i * bitsInWord to the next word, e.g., for a summary of full words
+    size_t getWord(size_t i) {
+        return words[i];
+    }
+
+    void addAll();
+    void removeAll();
+    void unionWith(_BitSet* other);
+    void intersectWith(_BitSet* other);
+    void subtract(_BitSet* other);
+
+    bool isEmpty();
+    bool equals(_BitSet* other);
+    size_t count();
+
+    // The first bit at or after start which is set, or unset, or notFound
+    size_t findFirst(size_t start = 0);
+    size_t findFirstMissing(size_t start = 0);
+
+    // Calls f with each set bit in ascending order
+    template<class F> void forEach(F f) {
+        for (size_t i = 0; i < length; i++) {
+            for (size_t word = words[i]; word; word &= word - 1)
+                f(i * bitsInWord + _lowestSetBit(word));
+        }
+    }
+
+private:
+    // Clears the bits of the last word beyond size
+    void trim();
+
+    size_t size;
+    size_t length;
+    size_t* words;
+};
+
+}
+#endif // __Scaly__BitSet__
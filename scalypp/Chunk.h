@@ -5,7 +5,8 @@ namespace scaly {
 
 class _Chunk : public Object {
 public:
-    static _Chunk* create();
+    // The pages of the chunk are preferably placed on node, unless it is -1
+    static _Chunk* create(int node);
     _Chunk();
     _Page* allocatePage();
     bool deallocatePage(_Page* page);
@@ -19,11 +20,8 @@ public:
     static const size_t numberOfPages = numberOfPagesInBucket * numberOfPagesInBucket;
 
 private:
-    static size_t findLowestZeroBit64(size_t index);
-    static size_t findLowestZeroBit32(size_t index);
-
-    // A 512 bytes long map whose bits indicate which of our 4096 pages are currently allocated
-    size_t* allocationMap;
+    // The bits of our 4096 pages which are currently allocated, a word per bucket
+    _BitSet* allocationMap;
     
     // 64 bits which indicate which buckets are completely full
     size_t bucketMap;
@@ -0,0 +1,120 @@
+#ifndef __Scaly__Deque__
+#define __Scaly__Deque__
+#include "Scaly.h"
+namespace scaly {
+
+// A growable deque of pointers for handing out work: the owning thread pushes
+// and pops at the bottom, while any other thread may steal from the top. This
+// is the deque of Chase and Lev with the memory orders of Le et al. When the
+// slots run out, the owner copies them to twice as many on a new page, which is
+// exclusive to the page of the old ones. The old slots may still be read by a
+// thief, so they stay until the deque's page goes away. Items must not be 0.
+template<class T> class alignas(_cacheLineSize) _Deque : public Object {
+public:
+    // A deque of at least capacity slots, rounded up to a power of two
+    _Deque<T>(size_t capacity = 64)
+    : top(0), bottom(0), slotsPage(_getPage()) {
+        slots.store(allocateSlots(_RingBuffer<T>::roundUp(capacity)), std::memory_order_relaxed);
+    }
+
+    void* operator new(size_t size, _Page* page) {
+        return alignToCacheLine((char*)Object::operator new(size + _cacheLineSize - _alignment, page));
+    }
+
+    // Called by the owner only
+    void push(T* item) {
+        intptr_t b = bottom.load(std::memory_order_relaxed);
+        intptr_t t = top.load(std::memory_order_acquire);
+        _Slots* s = slots.load(std::memory_order_relaxed);
+        if (b - t > (intptr_t)s->mask)
+            s = grow(s, t, b);
+
+        s->items[b & s->mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Called by the owner only. Returns the item pushed last, or 0 if the deque is empty.
+    T* pop() {
+        intptr_t b = bottom.load(std::memory_order_relaxed) - 1;
+        _Slots* s = slots.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        intptr_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return 0;
+        }
+
+        T* item = s->items[b & s->mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            // The last item, which a thief may be taking at the same time
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                item = 0;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        return item;
+    }
+
+    // Called by any thread. Returns the item pushed first, or 0 if the deque
+    // is empty or another thread took the item first.
+    T* steal() {
+        intptr_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        intptr_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return 0;
+
+        _Slots* s = slots.load(std::memory_order_acquire);
+        T* item = s->items[t & s->mask].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return 0;
+
+        return item;
+    }
+
+    // A snapshot which may be outdated as soon as it is taken
+    size_t length() {
+        intptr_t b = bottom.load(std::memory_order_relaxed);
+        intptr_t t = top.load(std::memory_order_relaxed);
+        return b > t ? b - t : 0;
+    }
+
+private:
+    struct _Slots {
+        size_t mask;
+        std::atomic<T*> items[1];
+    };
+
+    // The owner may run on another thread than the one which owns the deque's page,
+    // so only the constructor allocates from that page
+    _Slots* allocateSlots(size_t size) {
+        _Page* page = slotsPage->allocateExclusivePage();
+        slotsPage = page;
+        _Slots* s = (_Slots*)page->allocateObject(sizeof(_Slots) + (size - 1) * sizeof(std::atomic<T*>));
+        s->mask = size - 1;
+        return s;
+    }
+
+    _Slots* grow(_Slots* s, intptr_t t, intptr_t b) {
+        _Slots* grown = allocateSlots((s->mask + 1) * 2);
+        for (intptr_t i = t; i < b; i++)
+            grown->items[i & grown->mask].store(s->items[i & s->mask].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        slots.store(grown, std::memory_order_release);
+        return grown;
+    }
+
+    // Written by thieves and by the owner taking the last item
+    alignas(_cacheLineSize) std::atomic<intptr_t> top;
+
+    // Written by the owner only
+    alignas(_cacheLineSize) std::atomic<intptr_t> bottom;
+    std::atomic<_Slots*> slots;
+
+    // Where the slots were allocated last, used by the owner only
+    _Page* slotsPage;
+};
+
+}
+#endif//__Scaly__Deque__
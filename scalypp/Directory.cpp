@@ -6,10 +6,6 @@ long DirectoryError::_getErrorCode() {
     return errorCode;
 }
 
-void* DirectoryError::_getErrorInfo() {
-    return 0;
-}
-
 bool Directory::exists(string* path) {
     struct stat sb;
 
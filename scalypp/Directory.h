@@ -13,7 +13,6 @@ public:
     : errorCode(fileErrorCode) {}
     
     long _getErrorCode();
-    void* _getErrorInfo();
 
 private:
     _DirectoryErrorCode errorCode;
@@ -1,24 +1,17 @@
 #include "Scaly.h"
 #include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
 namespace scaly {
 
 long FileError::_getErrorCode() {
     return errorCode;
 }
 
-void* FileError::_getErrorInfo() {
-    return 0;
-}
-
 _Result<string, FileError> File::readToString(_Page* _rp, _Page* _ep, string* path) {
     FILE* file = fopen(path->getNativeString(), "rb");
-    if (!file) {
-        _FileErrorCode fileErrorCode = _FileErrorCode_unknownError;
-        switch (errno) {
-            case ENOENT: fileErrorCode = _FileErrorCode_noSuchFileOrDirectory; break;
-        }
-        return _Result<string, FileError>(new(_ep) FileError(fileErrorCode));
-    }
+    if (!file)
+        return _Result<string, FileError>(FileError(getFileErrorCode()));
     
     fseek(file, 0, SEEK_END);
     long size = ftell(file);
@@ -27,23 +20,57 @@ _Result<string, FileError> File::readToString(_Page* _rp, _Page* _ep, string* pa
     char* buffer = ret->getNativeString();
     fread (buffer, 1, size, file);
     fclose (file);
-    
+
+    if (!_isValidUtf8(buffer, (size_t)size))
+        return _Result<string, FileError>(FileError(_FileErrorCode_invalidUtf8));
+
     return ret;
 }
 
+FileRead* File::readToStringAsync(_Page* _rp, string* path) {
+    return new(_rp) FileRead(readToString, path);
+}
+
 FileError* File::writeFromString(_Page *_ep, VarString* path, VarString* contents) {
+    return writeFromBuffer(_ep, path, contents->getNativeString(), contents->getLength());
+}
+
+FileError* File::writeFromString(_Page *_ep, VarString* path, _StringBuilder* contents) {
+    return writeFromBuffer(_ep, path, contents->getNativeString(), contents->getLength());
+}
+
+FileError* File::writeFromString(_Page *_ep, VarString* path, _Rope* contents) {
+    int file = open(path->getNativeString(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (file < 0)
+        return getFileError(_ep);
+
+    bool written = contents->writeTo(file);
+    close(file);
+    if (!written)
+        return new(_ep) FileError(_FileErrorCode_unknownError);
+
+    return 0;
+}
+
+FileError* File::writeFromBuffer(_Page *_ep, VarString* path, const char* buffer, size_t length) {
     FILE* file = fopen(path->getNativeString(), "wb");
-    if (!file) {
-        _FileErrorCode fileErrorCode = _FileErrorCode_unknownError;
-        switch (errno) {
-            case ENOENT: fileErrorCode = _FileErrorCode_noSuchFileOrDirectory; break;
-        }
-        return new(_ep) FileError(fileErrorCode);
-    }
+    if (!file)
+        return getFileError(_ep);
 
-    fwrite(contents->getNativeString(), 1, contents->getLength(), file);
+    fwrite(buffer, 1, length, file);
     fclose (file);
     return 0;
 }
 
+FileError* File::getFileError(_Page *_ep) {
+    return new(_ep) FileError(getFileErrorCode());
+}
+
+_FileErrorCode File::getFileErrorCode() {
+    switch (errno) {
+        case ENOENT: return _FileErrorCode_noSuchFileOrDirectory;
+        default: return _FileErrorCode_unknownError;
+    }
+}
+
 }
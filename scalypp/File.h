@@ -5,6 +5,7 @@ namespace scaly {
 enum _FileErrorCode {
     _FileErrorCode_unknownError = 1,
     _FileErrorCode_noSuchFileOrDirectory,
+    _FileErrorCode_invalidUtf8,
 };
 
 class FileError : public Object {
@@ -13,17 +14,28 @@ public:
     : errorCode(fileErrorCode) {}
     
     long _getErrorCode();
-    void* _getErrorInfo();
 
 private:
     _FileErrorCode errorCode;
 
 };
 
+// A read of a file on a worker thread. get hands over the contents or the error.
+typedef _Future<string, FileError, string> FileRead;
+
 class File {
 public:
+    // Fails with invalidUtf8 if the contents are not valid UTF-8
     static _Result<string, FileError> readToString(_Page* _rp, _Page *_ep, string* path);
+    static FileRead* readToStringAsync(_Page* _rp, string* path);
     static FileError* writeFromString(_Page *_ep, VarString* path, VarString* contents);
+    static FileError* writeFromString(_Page *_ep, VarString* path, _StringBuilder* contents);
+    static FileError* writeFromString(_Page *_ep, VarString* path, _Rope* contents);
+
+private:
+    static FileError* writeFromBuffer(_Page *_ep, VarString* path, const char* buffer, size_t length);
+    static FileError* getFileError(_Page *_ep);
+    static _FileErrorCode getFileErrorCode();
 };
 
 }
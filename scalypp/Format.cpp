@@ -0,0 +1,64 @@
+#include "Scaly.h"
+#include <assert.h>
+namespace scaly {
+
+// Hands the literal parts of the pattern and the arguments in their place to sink
+template<class S> static void forEachPart(const char* pattern, size_t length, _FormatArgument* arguments, size_t count, S& sink) {
+    size_t argument = 0;
+    size_t start = 0;
+    for (size_t i = 0; i < length; i++) {
+        char c = pattern[i];
+        if (c != '{' && c != '}')
+            continue;
+
+        sink(pattern + start, i - start);
+        start = i;
+        if (i + 1 == length)
+            break;
+
+        if (pattern[i + 1] == c) {
+            // A doubled brace stands for one
+            i++;
+            start = i;
+        }
+        else if (c == '{' && pattern[i + 1] == '}') {
+            // Without an argument the {} is kept
+            assert(argument < count);
+            if (argument < count) {
+                sink(arguments[argument].getData(), arguments[argument].getLength());
+                argument++;
+                i++;
+                start = i + 1;
+            }
+        }
+    }
+    sink(pattern + start, length - start);
+    assert(argument == count);
+}
+
+struct _FormatMeasure {
+    size_t length;
+    void operator()(const char*, size_t size) {
+        length += size;
+    }
+};
+
+struct _FormatWrite {
+    char* end;
+    void operator()(const char* data, size_t size) {
+        memcpy(end, data, size);
+        end += size;
+    }
+};
+
+string* _format(_Page* _rp, const char* pattern, size_t length, _FormatArgument* arguments, size_t count) {
+    _FormatMeasure measure = { 0 };
+    forEachPart(pattern, length, arguments, count, measure);
+
+    string* ret = new(_rp) string(measure.length);
+    _FormatWrite write = { ret->getNativeString() };
+    forEachPart(pattern, length, arguments, count, write);
+    return ret;
+}
+
+}
@@ -0,0 +1,99 @@
+#ifndef __Scaly__Format__
+#define __Scaly__Format__
+namespace scaly {
+
+// An argument of format as text. Numbers are written into the argument itself,
+// so that their length is known before the result is allocated.
+class _FormatArgument {
+public:
+    _FormatArgument()
+    : data(0), length(0) {}
+
+    _FormatArgument(string* theString)
+    : data(theString->getNativeString()), length(theString->getLength()) {}
+
+    _FormatArgument(VarString* theString)
+    : data(theString->getNativeString()), length(theString->getLength()) {}
+
+    _FormatArgument(_Slice slice)
+    : data(slice.getData()), length(slice.getLength()) {}
+
+    _FormatArgument(const char* theString)
+    : data(theString), length(strlen(theString)) {}
+
+    _FormatArgument(char c)
+    : data(0), length(1) {
+        digits[0] = c;
+    }
+
+    _FormatArgument(int number)
+    : data(0), length(Number::writeSigned(digits, number) - digits) {}
+
+    _FormatArgument(long number)
+    : data(0), length(Number::writeSigned(digits, number) - digits) {}
+
+    _FormatArgument(long long number)
+    : data(0), length(Number::writeSigned(digits, number) - digits) {}
+
+    _FormatArgument(unsigned int number)
+    : data(0), length(Number::writeDecimal(digits, number) - digits) {}
+
+    _FormatArgument(unsigned long number)
+    : data(0), length(Number::writeDecimal(digits, number) - digits) {}
+
+    _FormatArgument(unsigned long long number)
+    : data(0), length(Number::writeDecimal(digits, number) - digits) {}
+
+    _FormatArgument(double number)
+    : data(0), length(Number::writeFloat(digits, number) - digits) {}
+
+    // The digits are found through this, so that a copy still finds its own
+    const char* getData() const {
+        return data ? data : digits;
+    }
+
+    size_t getLength() const {
+        return length;
+    }
+
+private:
+    const char* data;
+    size_t length;
+    char digits[Number::maxLength];
+};
+
+// The pattern with each {} replaced by the next argument, and {{ and }} by a
+// brace, as one string on _rp, e.g.,
+//     format(_rp, "Syntax error in {} at {}, {}\n", file, line, column)
+// The length of the pattern comes from the literal, and which conversion an
+// argument takes is settled by the compiler. The arguments are converted into
+// text first, so that the result is allocated once at its final length.
+// There must be an argument for each {}, which is asserted. SCALY_FORMAT
+// checks it at compile time.
+string* _format(_Page* _rp, const char* pattern, size_t length, _FormatArgument* arguments, size_t count);
+
+template<size_t N, class... Arguments> string* format(_Page* _rp, const char (&pattern)[N], Arguments... arguments) {
+    // The last one only keeps the array from being empty
+    _FormatArgument converted[] = { arguments..., _FormatArgument() };
+    return _format(_rp, pattern, N - 1, converted, sizeof...(Arguments));
+}
+
+// The number of {} in pattern, counted like _format does
+constexpr size_t _countPlaceholders(const char* pattern) {
+    return !*pattern ? 0
+        : (*pattern == '{' || *pattern == '}') && pattern[1] == *pattern ? _countPlaceholders(pattern + 2)
+        : *pattern == '{' && pattern[1] == '}' ? 1 + _countPlaceholders(pattern + 2)
+        : _countPlaceholders(pattern + 1);
+}
+
+template<size_t placeholders, size_t N, class... Arguments> string* _formatChecked(_Page* _rp, const char (&pattern)[N], Arguments... arguments) {
+    static_assert(placeholders == sizeof...(Arguments), "format needs one argument for each {} of its pattern");
+    return format(_rp, pattern, arguments...);
+}
+
+}
+
+// format with the number of arguments checked against the pattern, which
+// must be a literal. The generated code calls format through this.
+#define SCALY_FORMAT(page, pattern, ...) scaly::_formatChecked<scaly::_countPlaceholders(pattern)>(page, pattern, ##__VA_ARGS__)
+#endif // __Scaly__Format__
@@ -0,0 +1,96 @@
+#ifndef __Scaly_Future__
+#define __Scaly_Future__
+#include "Scaly.h"
+namespace scaly {
+
+extern __thread _Task* __CurrentTask;
+
+// A computation on a worker thread of its own. get has to be called before the
+// page of the future goes away: the worker writes into the future until get has
+// joined it, and only get hands the result and error pages over to the caller.
+// A task which is disposed of with futures still uncollected fails an assertion.
+// If no worker can be had, get does the computation in the caller's thread.
+template<class R, class E, class A> class _Future : public Object {
+public:
+    // The computation allocates its result at _rp and its error at _ep
+    typedef _Result<R, E> (*_Computation)(_Page* _rp, _Page* _ep, A* argument);
+
+    // Launch the computation on a worker thread
+    _Future(_Computation computation, A* argument)
+    : computation(computation), argument(argument), task(__CurrentTask), resultPage(0), errorPage(0), result(0), spawned(false), collected(false) {
+        // Beyond a worker per CPU, get computes right into the caller's pages
+        if (!task->launchFuture())
+            return;
+
+        // The worker allocates into pages which are adopted by the caller's pages later
+        resultPage = task->getExtensionPage();
+        errorPage = task->getExtensionPage();
+        if (!resultPage || !errorPage) {
+            // get computes right into the caller's pages instead
+            if (resultPage)
+                task->releaseExtensionPage(resultPage);
+            if (errorPage)
+                task->releaseExtensionPage(errorPage);
+            resultPage = 0;
+            errorPage = 0;
+            return;
+        }
+
+        resultPage->reset();
+        errorPage->reset();
+        spawned = pthread_create(&thread, 0, run, this) == 0;
+    }
+
+    // Wait for the computation and hand over its result and error pages
+    _Result<R, E> get(_Page* _rp, _Page* _ep) {
+        if (!collected) {
+            if (spawned)
+                pthread_join(thread, 0);
+
+            if (!resultPage) {
+                result = new(_rp) _Result<R, E>(computation(_rp, _ep, argument));
+            }
+            else {
+                // If no worker could do it, we compute in the caller's thread
+                if (!result)
+                    execute();
+
+                _rp->adoptExclusivePage(resultPage);
+                _ep->adoptExclusivePage(errorPage);
+            }
+
+            collected = true;
+            task->collectFuture();
+        }
+
+        return *result;
+    }
+
+private:
+    static void* run(void* future) {
+        _Future<R, E, A>* self = (_Future<R, E, A>*)future;
+        _Page* rootPage = _Task::enterThread(self->task);
+        if (!rootPage)
+            return 0;
+        self->execute();
+        _Task::leaveThread(rootPage);
+        return 0;
+    }
+
+    void execute() {
+        result = new(resultPage) _Result<R, E>(computation(resultPage, errorPage, argument));
+    }
+
+    _Computation computation;
+    A* argument;
+    _Task* task;
+    _Page* resultPage;
+    _Page* errorPage;
+    _Result<R, E>* result;
+    pthread_t thread;
+    bool spawned;
+    bool collected;
+};
+
+}
+#endif//__Scaly_Future__
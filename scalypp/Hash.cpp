@@ -0,0 +1,342 @@
+#include "Scaly.h"
+#if defined(__GNUC__) && defined(__x86_64__)
+#define __Scaly_x86__
+#include <immintrin.h>
+#endif
+namespace scaly {
+
+// The constants of wyhash
+static const uint64_t secret[4] = {
+    0xa0761d6478bd642f, 0xe7037ed1a0b428db, 0x8ebc6af09c88c6e3, 0x589965cc75374cc3,
+};
+
+// Stripe n of a block is keyed by the eight keys from n on, and the scrambling
+// after a block by the last eight. They are the output of splitmix64.
+static const uint64_t laneKeys[24] = {
+    0x2cb0f69f4abea221, 0x9417034723148989, 0xdd555950609dfe03, 0xdbafb150deb12800,
+    0x7e789b2e6c442cb6, 0xf41e5636c7e4f8c4, 0x0959d150f8fba7e4, 0xa97316f13cdb9eea,
+    0x74cd8258f9520068, 0x55c74a62e116868b, 0xd2f4c799a2023cbd, 0xdf98cb79a37b51b9,
+    0x396f5885524f3905, 0xaf1d56386ca3b276, 0xa9ffbe6b5104e85a, 0x6bd0c51b9fd533b3,
+    0x980ce91c50ab4b56, 0x28ac395780fe62c5, 0x768912e3a6bcedc7, 0x50b3e8c9332c7c88,
+    0xce3bbfe520bd47da, 0xcba6c8e8e0bb7c4f, 0xbf194db8434a346d, 0x7d8f2a7b60416d7f,
+};
+
+// The lanes start out with the primes of XXH3
+static const uint64_t initialLanes[8] = {
+    0x00000000c2b2ae3d, 0x9e3779b185ebca87, 0xc2b2ae3d27d4eb4f, 0x165667b19e3779f9,
+    0x85ebca77c2b2ae63, 0x0000000085ebca77, 0x27d4eb2f165667c5, 0x000000009e3779b1,
+};
+
+// The seed of wyhash for 0, i.e., mix(secret[0], secret[1])
+static const uint64_t initialSeed = 0x1ff5c2923a788d2c;
+
+static const uint64_t scramblePrime = 0x9e3779b1;
+static const size_t stripeLength = 64;
+static const size_t stripesInBlock = Hash::blockLength / stripeLength;
+
+// Bytes are read as little endian numbers, so the hash is the same on all machines
+static inline uint64_t read64(const unsigned char* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof value);
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+static inline uint64_t read32(const unsigned char* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof value);
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap32(value);
+#endif
+    return value;
+}
+
+// The 128 bit product of a and b, with the low half in a and the high half in b
+static inline void multiply(uint64_t* a, uint64_t* b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = (__uint128_t)*a * *b;
+    *a = (uint64_t)product;
+    *b = (uint64_t)(product >> 64);
+#else
+    uint64_t aHigh = *a >> 32, aLow = (uint32_t)*a, bHigh = *b >> 32, bLow = (uint32_t)*b;
+    uint64_t high = aHigh * bHigh, middle0 = aHigh * bLow, middle1 = aLow * bHigh, low = aLow * bLow;
+    uint64_t t = low + (middle0 << 32);
+    uint64_t carry = t < low;
+    uint64_t lowHalf = t + (middle1 << 32);
+    carry += lowHalf < t;
+    *a = lowHalf;
+    *b = high + (middle0 >> 32) + (middle1 >> 32) + carry;
+#endif
+}
+
+static inline uint64_t mix(uint64_t a, uint64_t b) {
+    multiply(&a, &b);
+    return a ^ b;
+}
+
+// wyhash of up to a block of bytes, with a seed which is mixed already
+static uint64_t hashShort(const unsigned char* p, size_t length, uint64_t seed) {
+    uint64_t a, b;
+    if (length <= 16) {
+        if (length >= 4) {
+            // Two overlapping reads of four bytes from each end cover all bytes
+            size_t offset = (length >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + offset);
+            b = (read32(p + length - 4) << 32) | read32(p + length - 4 - offset);
+        }
+        else if (length > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) | p[length - 1];
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
+    }
+    else {
+        size_t i = length;
+        if (i > 48) {
+            // Three independent lanes keep the multiplier busy
+            uint64_t seed1 = seed, seed2 = seed;
+            do {
+                seed = mix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+                seed1 = mix(read64(p + 16) ^ secret[2], read64(p + 24) ^ seed1);
+                seed2 = mix(read64(p + 32) ^ secret[3], read64(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16) {
+            seed = mix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    multiply(&a, &b);
+    return mix(a ^ secret[0] ^ length, b ^ secret[1]);
+}
+
+// Each lane adds the product of the halves of its keyed word, and the word of
+// its neighbour. After a block, the lanes are scrambled.
+static void accumulatePortable(uint64_t* lanes, const unsigned char* block, size_t blocks) {
+    for (size_t k = 0; k < blocks; k++, block += Hash::blockLength) {
+        for (size_t n = 0; n < stripesInBlock; n++) {
+            const unsigned char* stripe = block + n * stripeLength;
+            for (size_t i = 0; i < 8; i++) {
+                uint64_t word = read64(stripe + 8 * i);
+                uint64_t keyed = word ^ laneKeys[n + i];
+                lanes[i ^ 1] += word;
+                lanes[i] += (keyed & 0xffffffff) * (keyed >> 32);
+            }
+        }
+
+        for (size_t i = 0; i < 8; i++) {
+            uint64_t lane = lanes[i];
+            lane ^= lane >> 47;
+            lane ^= laneKeys[stripesInBlock + i];
+            lanes[i] = lane * scramblePrime;
+        }
+    }
+}
+
+#ifdef __Scaly_x86__
+
+// The same with two lanes per register
+static void accumulateSse2(uint64_t* lanes, const unsigned char* block, size_t blocks) {
+    __m128i l[4];
+    for (size_t i = 0; i < 4; i++)
+        l[i] = _mm_loadu_si128((const __m128i*)lanes + i);
+
+    const __m128i prime = _mm_set1_epi64x(scramblePrime);
+    for (size_t k = 0; k < blocks; k++, block += Hash::blockLength) {
+        for (size_t n = 0; n < stripesInBlock; n++) {
+            const unsigned char* stripe = block + n * stripeLength;
+            for (size_t i = 0; i < 4; i++) {
+                __m128i word = _mm_loadu_si128((const __m128i*)stripe + i);
+                __m128i keyed = _mm_xor_si128(word, _mm_loadu_si128((const __m128i*)(laneKeys + n + 2 * i)));
+                __m128i product = _mm_mul_epu32(keyed, _mm_srli_epi64(keyed, 32));
+                __m128i swapped = _mm_shuffle_epi32(word, _MM_SHUFFLE(1, 0, 3, 2));
+                l[i] = _mm_add_epi64(l[i], _mm_add_epi64(product, swapped));
+            }
+        }
+
+        for (size_t i = 0; i < 4; i++) {
+            __m128i lane = _mm_xor_si128(l[i], _mm_srli_epi64(l[i], 47));
+            lane = _mm_xor_si128(lane, _mm_loadu_si128((const __m128i*)(laneKeys + stripesInBlock + 2 * i)));
+            // The 64 bit product with a 32 bit prime out of two 32 bit products
+            __m128i low = _mm_mul_epu32(lane, prime);
+            __m128i high = _mm_mul_epu32(_mm_srli_epi64(lane, 32), prime);
+            l[i] = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+        }
+    }
+
+    for (size_t i = 0; i < 4; i++)
+        _mm_storeu_si128((__m128i*)lanes + i, l[i]);
+}
+
+__attribute__((target("avx2")))
+static void accumulateAvx2(uint64_t* lanes, const unsigned char* block, size_t blocks) {
+    __m256i l[2];
+    for (size_t i = 0; i < 2; i++)
+        l[i] = _mm256_loadu_si256((const __m256i*)lanes + i);
+
+    const __m256i prime = _mm256_set1_epi64x(scramblePrime);
+    for (size_t k = 0; k < blocks; k++, block += Hash::blockLength) {
+        for (size_t n = 0; n < stripesInBlock; n++) {
+            const unsigned char* stripe = block + n * stripeLength;
+            for (size_t i = 0; i < 2; i++) {
+                __m256i word = _mm256_loadu_si256((const __m256i*)stripe + i);
+                __m256i keyed = _mm256_xor_si256(word, _mm256_loadu_si256((const __m256i*)(laneKeys + n + 4 * i)));
+                __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+                __m256i swapped = _mm256_shuffle_epi32(word, _MM_SHUFFLE(1, 0, 3, 2));
+                l[i] = _mm256_add_epi64(l[i], _mm256_add_epi64(product, swapped));
+            }
+        }
+
+        for (size_t i = 0; i < 2; i++) {
+            __m256i lane = _mm256_xor_si256(l[i], _mm256_srli_epi64(l[i], 47));
+            lane = _mm256_xor_si256(lane, _mm256_loadu_si256((const __m256i*)(laneKeys + stripesInBlock + 4 * i)));
+            __m256i low = _mm256_mul_epu32(lane, prime);
+            __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(lane, 32), prime);
+            l[i] = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+        }
+    }
+
+    for (size_t i = 0; i < 2; i++)
+        _mm256_storeu_si256((__m256i*)lanes + i, l[i]);
+    _mm256_zeroupper();
+}
+
+// Detected on first use; the initialization of a local static is thread safe
+static bool hasAvx2() {
+    static const bool avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return avx2;
+}
+
+#endif
+
+typedef void (*_Accumulate)(uint64_t* lanes, const unsigned char* block, size_t blocks);
+
+// The kernel for the CPU, which the hash uses
+static void accumulate(uint64_t* lanes, const unsigned char* block, size_t blocks) {
+#ifdef __Scaly_x86__
+    if (hasAvx2())
+        accumulateAvx2(lanes, block, blocks);
+    else
+        accumulateSse2(lanes, block, blocks);
+#else
+    accumulatePortable(lanes, block, blocks);
+#endif
+}
+
+// The kernel, or 0 if the CPU does not have it
+static _Accumulate getAccumulate(Hash::Kernel kernel) {
+    switch (kernel) {
+        case Hash::portableKernel:
+            return accumulatePortable;
+#ifdef __Scaly_x86__
+        case Hash::sse2Kernel:
+            return accumulateSse2;
+        case Hash::avx2Kernel:
+            return hasAvx2() ? accumulateAvx2 : 0;
+#endif
+        default:
+            return 0;
+    }
+}
+
+// The seed of the last block, from the lanes and the length of all bytes
+static uint64_t merge(const uint64_t* lanes, size_t length) {
+    uint64_t result = length * 0x9e3779b97f4a7c15;
+    for (size_t i = 0; i < 4; i++)
+        result += mix(lanes[2 * i] ^ laneKeys[2 * i + 3], lanes[2 * i + 1] ^ laneKeys[2 * i + 4]);
+    result ^= result >> 37;
+    result *= 0x165667919e3779f9;
+    return result ^ (result >> 32);
+}
+
+static size_t hash(const unsigned char* p, size_t length, _Accumulate accumulate) {
+    if (length <= Hash::blockLength)
+        return hashShort(p, length, initialSeed);
+
+    // The last block is hashed like a short input, so at least one byte is left for it
+    size_t blocks = (length - 1) / Hash::blockLength;
+    uint64_t lanes[8];
+    memcpy(lanes, initialLanes, sizeof lanes);
+    accumulate(lanes, p, blocks);
+    return hashShort(p + blocks * Hash::blockLength, length - blocks * Hash::blockLength, merge(lanes, length));
+}
+
+size_t Hash::of(const char* data, size_t length) {
+    return hash((const unsigned char*)data, length, accumulate);
+}
+
+bool Hash::hasKernel(Kernel kernel) {
+    return getAccumulate(kernel) != 0;
+}
+
+size_t Hash::of(const char* data, size_t length, Kernel kernel) {
+    return hash((const unsigned char*)data, length, getAccumulate(kernel));
+}
+
+size_t Hash::of(_Slice slice) {
+    return of(slice.getData(), slice.getLength());
+}
+
+size_t Hash::of(string* theString) {
+    return theString->getHash();
+}
+
+Hasher::Hasher()
+: length(0), buffered(0) {
+    memcpy(lanes, initialLanes, sizeof lanes);
+}
+
+void Hasher::append(const char* data, size_t length) {
+    this->length += length;
+    while (length) {
+        // A full block is only added once more bytes arrive, since the last one is hashed apart
+        if (buffered == Hash::blockLength) {
+            accumulate(lanes, (const unsigned char*)buffer, 1);
+            buffered = 0;
+        }
+
+        // Whole blocks are added straight from the data, except the last one
+        if (!buffered && length > Hash::blockLength) {
+            size_t blocks = (length - 1) / Hash::blockLength;
+            accumulate(lanes, (const unsigned char*)data, blocks);
+            data += blocks * Hash::blockLength;
+            length -= blocks * Hash::blockLength;
+        }
+
+        size_t copied = Hash::blockLength - buffered < length ? Hash::blockLength - buffered : length;
+        memcpy(buffer + buffered, data, copied);
+        buffered += copied;
+        data += copied;
+        length -= copied;
+    }
+}
+
+void Hasher::append(_Slice slice) {
+    append(slice.getData(), slice.getLength());
+}
+
+void Hasher::append(string* theString) {
+    append(theString->getNativeString(), theString->getLength());
+}
+
+size_t Hasher::finish() {
+    if (length <= Hash::blockLength)
+        return hashShort((const unsigned char*)buffer, buffered, initialSeed);
+
+    return hashShort((const unsigned char*)buffer, buffered, merge(lanes, length));
+}
+
+}
@@ -0,0 +1,54 @@
+#ifndef __Scaly__Hash__
+#define __Scaly__Hash__
+namespace scaly {
+
+class string;
+class _Slice;
+
+// A fast hash of bytes which is not meant to withstand an attacker.
+// Up to blockLength bytes are hashed with 64 bit multiply and mix steps like
+// wyhash. Longer inputs go through eight lanes a 64 byte stripe at a time like
+// XXH3, which use SSE2 on x86, or AVX2 if the CPU has it. All ways compute the
+// same hash, so it may be stored, e.g., in a build cache.
+class Hash {
+public:
+    static const size_t blockLength = 1024;
+
+    static size_t of(const char* data, size_t length);
+    static size_t of(_Slice slice);
+
+    // The hash a string caches, which is the hash of its bytes
+    static size_t of(string* theString);
+
+    // The ways whole blocks can be added up, which all give the same hash
+    enum Kernel { portableKernel, sse2Kernel, avx2Kernel };
+    static bool hasKernel(Kernel kernel);
+
+    // The hash with blocks added up by kernel, which the CPU has to have,
+    // so that bench can check that the kernels agree
+    static size_t of(const char* data, size_t length, Kernel kernel);
+};
+
+// Hashes bytes which arrive piece by piece, e.g., while a file is read.
+// The hash is the same as that of all pieces in one.
+class Hasher : public Object {
+public:
+    Hasher();
+    void append(const char* data, size_t length);
+    void append(_Slice slice);
+    void append(string* theString);
+
+    // The hash of the bytes appended so far. More may be appended afterwards.
+    size_t finish();
+
+private:
+    uint64_t lanes[8];
+    size_t length;
+
+    // The bytes of the block which is not yet added to the lanes
+    size_t buffered;
+    char buffer[Hash::blockLength];
+};
+
+}
+#endif // __Scaly__Hash__
@@ -0,0 +1,139 @@
+#ifndef __Scaly__HashMap__
+#define __Scaly__HashMap__
+#include "Scaly.h"
+namespace scaly {
+
+// An open addressing hash map with linear probing, keyed by strings.
+// K has to provide getNativeString, getLength and getHash like string and VarString do.
+template<class K, class V> class _HashMap : public Object {
+public:
+    _HashMap<K, V>()
+    : _size(0), _capacity(0), _slots(0) {}
+
+    _HashMap<K, V>(size_t capacity)
+    : _size(0), _capacity(0), _slots(0) {
+        reserve(capacity);
+    }
+
+    size_t length() {
+        return _size;
+    }
+
+    // Insert or replace the value of a key. Returns false if the key was already present.
+    bool insert(K* key, V* value) {
+        if ((_size + 1) * 4 > _capacity * 3)
+            reHash(_capacity ? _capacity * 2 : 16);
+
+        size_t hash = key->getHash();
+        _Slot* slot = find(key->getNativeString(), key->getLength(), hash);
+        if (slot->key) {
+            slot->value = value;
+            return false;
+        }
+
+        slot->hash = hash;
+        slot->key = key;
+        slot->value = value;
+        _size++;
+        return true;
+    }
+
+    // The value of a key, or 0 if it is not present
+    V* get(K* key) {
+        if (!_size)
+            return 0;
+
+        return find(key->getNativeString(), key->getLength(), key->getHash())->value;
+    }
+
+    // The value of the key spelled by length bytes at data, or 0 if it is not present
+    V* get(const char* data, size_t length) {
+        if (!_size)
+            return 0;
+
+        return find(data, length, Hash::of(data, length))->value;
+    }
+
+    bool contains(K* key) {
+        if (!_size)
+            return false;
+
+        return find(key->getNativeString(), key->getLength(), key->getHash())->key != 0;
+    }
+
+    // Make room for capacity entries without rehashing
+    void reserve(size_t capacity) {
+        size_t slots = 16;
+        while (slots * 3 < capacity * 4)
+            slots *= 2;
+        if (slots > _capacity)
+            reHash(slots);
+    }
+
+private:
+    struct _Slot {
+        size_t hash;
+        K* key;
+        V* value;
+    };
+
+    // The slot holding the key, or the empty slot where it would go
+    _Slot* find(const char* data, size_t length, size_t hash) {
+        size_t mask = _capacity - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            _Slot* slot = _slots + i;
+            if (!slot->key)
+                return slot;
+            if (slot->hash == hash && slot->key->getLength() == length &&
+                (slot->key->getNativeString() == data || !memcmp(slot->key->getNativeString(), data, length)))
+                return slot;
+        }
+    }
+
+    void reHash(size_t newCapacity) {
+        _Slot* oldSlots = _slots;
+        size_t oldCapacity = _capacity;
+        _capacity = newCapacity;
+        _slots = (_Slot*) _getPage()->allocateObject(_capacity * sizeof(_Slot));
+        memset(_slots, 0, _capacity * sizeof(_Slot));
+        if (!oldSlots)
+            return;
+
+        // The hashes are kept in the slots, so the keys are not hashed again
+        size_t mask = _capacity - 1;
+        for (size_t i = 0; i < oldCapacity; i++) {
+            _Slot* oldSlot = oldSlots + i;
+            if (!oldSlot->key)
+                continue;
+            size_t j = oldSlot->hash & mask;
+            while (_slots[j].key)
+                j = (j + 1) & mask;
+            _slots[j] = *oldSlot;
+        }
+
+        // Reclaim the page if it was oversized, i.e., exclusively allocated
+        if (((Object*)oldSlots)->_getPage()->isOversized())
+            _getPage()->reclaimArray(oldSlots);
+    }
+
+    size_t _size;
+    size_t _capacity;
+    _Slot* _slots;
+};
+
+// A set of strings on top of _HashMap, where every key is its own value
+template<class K> class _HashSet : public _HashMap<K, K> {
+public:
+    _HashSet<K>() {}
+
+    _HashSet<K>(size_t capacity)
+    : _HashMap<K, K>(capacity) {}
+
+    // Returns false if the key was already present
+    bool add(K* key) {
+        return _HashMap<K, K>::insert(key, key);
+    }
+};
+
+}
+#endif//__Scaly__HashMap__
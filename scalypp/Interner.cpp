@@ -0,0 +1,38 @@
+#include "Scaly.h"
+namespace scaly {
+
+Interner::Interner() {
+    symbols = new(_getPage()) StringSet(256);
+}
+
+string* Interner::intern(_Page*, char c) {
+    return lookup(&c, 1);
+}
+
+string* Interner::intern(_Page*, const char* theString) {
+    return lookup(theString, strlen(theString));
+}
+
+string* Interner::intern(_Page*, string* theString) {
+    return lookup(theString->getNativeString(), theString->getLength());
+}
+
+string* Interner::intern(_Page*, VarString* theString) {
+    return lookup(theString->getNativeString(), theString->getLength());
+}
+
+size_t Interner::length() {
+    return symbols->length();
+}
+
+string* Interner::lookup(const char* data, size_t length) {
+    string* symbol = symbols->get(data, length);
+    if (symbol)
+        return symbol;
+
+    symbol = new(_getPage()) string(data, length);
+    symbols->add(symbol);
+    return symbol;
+}
+
+}
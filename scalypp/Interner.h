@@ -0,0 +1,25 @@
+#ifndef __Scaly__Interner__
+#define __Scaly__Interner__
+namespace scaly {
+
+// Hands out one string per distinct spelling, allocated on the page of the interner,
+// so that interned strings are equal if and only if they are the same object.
+// Like any function returning an object, intern takes a return page, which it does
+// not need since the symbols live as long as the interner.
+class Interner : public Object {
+public:
+    Interner();
+    string* intern(_Page* _rp, char c);
+    string* intern(_Page* _rp, const char* theString);
+    string* intern(_Page* _rp, string* theString);
+    string* intern(_Page* _rp, VarString* theString);
+    size_t length();
+
+private:
+    string* lookup(const char* data, size_t length);
+
+    StringSet* symbols;
+};
+
+}
+#endif // __Scaly__Interner__
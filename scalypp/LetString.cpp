@@ -2,70 +2,103 @@
 namespace scaly {
 
 string::string()
-: buffer(0), length(0) {
+: length(0) {
+    chars[0] = 0;
 }
 
-string::string(const char c) {
-    length = 1;
-    buffer = (char*)_getPage()->allocateObject(length + 1);
+string::string(const char c)
+: length(1) {
+    char* buffer = allocate();
     buffer[0] = c;
     buffer[1] = 0;
 }
 
-string::string(const char* theString) {
-    length = strlen(theString);
-    buffer = (char*)_getPage()->allocateObject(length + 1);
+string::string(const char* theString)
+: length(strlen(theString)) {
     copyNativeString(theString, length);
 }
 
-string::string(string* theString) {
-    length = theString->getLength();
-    buffer = (char*)_getPage()->allocateObject(length + 1);
+string::string(const char* data, size_t theLength)
+: length(theLength) {
+    copyNativeString(data, length);
+}
+
+string::string(string* theString)
+: length(theString->length) {
     copyNativeString(theString->getNativeString(), length);
+    if (length > inlineCapacity)
+        buffer.hash.store(theString->buffer.hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
 }
 
-string::string(VarString* theString) {
-    length = theString->getLength();
-    buffer = (char*)_getPage()->allocateObject(length + 1);
+string::string(VarString* theString)
+: length(theString->getLength()) {
     copyNativeString(theString->getNativeString(), length);
 }
 
-string::string(size_t theLength) {
-    length = theLength;
-    buffer = (char*)_getPage()->allocateObject(length + 1);
-    buffer[length] = 0;
+string::string(size_t theLength)
+: length(theLength) {
+    allocate()[length] = 0;
 }
 
 char* string::getNativeString() const {
-    return buffer;
+    return length > inlineCapacity ? buffer.chars : (char*)chars;
 }
 
 size_t string::getLength() {
     return length;
 }
 
+size_t string::getHash() {
+    // Short strings are hashed quicker than a cache could be checked
+    if (length <= inlineCapacity)
+        return Hash::of(chars, length);
+
+    size_t hash = buffer.hash.load(std::memory_order_relaxed);
+    if (!hash) {
+        hash = Hash::of(buffer.chars, length);
+        buffer.hash.store(hash, std::memory_order_relaxed);
+    }
+
+    return hash;
+}
+
 bool string::equals(const char* theString){
-    return strcmp(getNativeString(), theString) == 0;
+    size_t theLength = strlen(theString);
+    return theLength == length && !memcmp(getNativeString(), theString, length);
 }
 
 bool string::notEquals(const char* theString){
-    return strcmp(getNativeString(), theString) != 0;
+    return !equals(theString);
 }
 
 bool string::equals(string* theString){
-    return strcmp(getNativeString(), theString->getNativeString()) == 0;
+    if (this == theString)
+        return true;
+
+    if (length != theString->length)
+        return false;
+
+    if (length <= inlineCapacity)
+        return !memcmp(chars, theString->chars, length);
+
+    size_t hash = buffer.hash.load(std::memory_order_relaxed);
+    size_t theHash = theString->buffer.hash.load(std::memory_order_relaxed);
+    if (hash && theHash && hash != theHash)
+        return false;
+
+    return !memcmp(buffer.chars, theString->buffer.chars, length);
 }
 
 bool string::notEquals(string* theString){
-    return strcmp(getNativeString(), theString->getNativeString()) != 0;
+    return !equals(theString);
 }
 
 bool string::equals(VarString* theString){
-    return strcmp(getNativeString(), theString->getNativeString()) == 0;
+    return length == theString->getLength() && !memcmp(getNativeString(), theString->getNativeString(), length);
 }
 
 bool string::notEquals(VarString* theString){
-    return strcmp(getNativeString(), theString->getNativeString()) != 0;
+    return !equals(theString);
 }
 
 char string::charAt(size_t i) {
@@ -75,35 +108,52 @@ char string::charAt(size_t i) {
     return -1;
 }
 
+size_t string::getCodePointCount() {
+    return _Slice(this).getCodePointCount();
+}
+
+bool string::nextCodePoint(size_t* position, uint32_t* codePoint) {
+    return _Slice(this).nextCodePoint(position, codePoint);
+}
+
+size_t string::getIdentifierStartLength(size_t position) {
+    return _Slice(this).getIdentifierStartLength(position);
+}
+
+size_t string::getIdentifierPartLength(size_t position) {
+    return _Slice(this).getIdentifierPartLength(position);
+}
+
+size_t string::find(char c, size_t start) {
+    if (start >= length)
+        return length;
+
+    return start + _findChar(getNativeString() + start, length - start, c);
+}
+
 _Array<string>& string::Split(_Page* _rp, char c) {
     _Array<string>* ret = new(_rp) _Array<string>();
-    VarString* part = 0;
-    for (size_t _i = 0; _i < length; _i++) {
-        char currentChar = this->charAt(_i);
-        if (currentChar == c) {
-            if (part) {
-                ret->push(new(_rp) string(part));
-                part = 0;
-            }
-        }
-        else {
-            if (!part)
-                part = new(_rp) VarString();
-            part->append(this->charAt(_i));
-        }
-    }
-
-    if (part)
-        ret->push(new(_rp) string(part));
+    _Slice rest(this);
+    _Slice part;
+    while (rest.split(c, &part))
+        ret->push(part.toString(_rp));
 
     return *ret;
 }
 
+char* string::allocate() {
+    if (length <= inlineCapacity)
+        return chars;
+
+    buffer.chars = (char*)_getPage()->allocateObject(length + 1);
+    buffer.hash.store(0, std::memory_order_relaxed);
+    return buffer.chars;
+}
+
 void string::copyNativeString(const char* theString, size_t length) {
-    if (length == 0)
-        buffer[0] = 0;
-    else
-        strcpy(buffer, theString);
+    char* buffer = allocate();
+    memcpy(buffer, theString, length);
+    buffer[length] = 0;
 }
 
 }
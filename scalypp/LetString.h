@@ -9,12 +9,20 @@ public:
     string();
     string(const char c);
     string(const char* theString);
+    string(const char* data, size_t theLength);
     string(string* theString);
     string(VarString* theString);
     string(size_t theLength);
     char* getNativeString() const;
     size_t getLength();
+    size_t getHash();
+    // The byte at i, or -1 past the end, which no byte of valid UTF-8 can be
     char charAt(size_t i);
+    size_t getCodePointCount();
+    bool nextCodePoint(size_t* position, uint32_t* codePoint);
+    size_t getIdentifierStartLength(size_t position);
+    size_t getIdentifierPartLength(size_t position);
+    size_t find(char c, size_t start);
     bool equals(const char* theString);
     bool notEquals(const char* theString);
     bool equals(string* theString);
@@ -24,13 +32,33 @@ public:
     _Array<string>& Split(_Page* _rp, char c);
 
 private:
+    // The builder hands its buffer over to the string it finishes
+    friend class _StringBuilder;
+
     // Disable copy constuctor
     string(const string&);
+    char* allocate();
     void copyNativeString(const char* theString, size_t length);
 
-    char* buffer;
+    // Short strings are kept within the object, leaving room for the trailing 0
+    static const size_t inlineCapacity = 23;
+
+    struct _Buffer {
+        char* chars;
+        // Computed on first use, 0 if not yet known. Threads which share the
+        // string may both compute it, but they store the same value.
+        std::atomic<size_t> hash;
+    };
+
     size_t length;
+    union {
+        _Buffer buffer;
+        char chars[inlineCapacity + 1];
+    };
 };
 
+// A set of strings, usable from Scaly code
+typedef _HashSet<string> StringSet;
+
 }
 #endif
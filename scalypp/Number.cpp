@@ -1,10 +1,497 @@
 #include "Scaly.h"
+#include <errno.h>
+#include <math.h>
 namespace scaly {
 
+// The shortest double formatting follows Grisu3 by Florian Loitsch, which finds
+// the digits with 64 bit arithmetic in all but a few rare cases, and reports those.
+
+// A floating point number of a 64 bit significand f and a binary exponent e
+struct _DiyFp {
+    uint64_t f;
+    int e;
+};
+
+// 10^decimal, from 10^-348 to 10^340 in steps of 8, each rounded to 64 bits
+struct _CachedPower {
+    uint64_t significand;
+    int binaryExponent;
+    int decimalExponent;
+};
+
+static const _CachedPower cachedPowers[] = {
+    {0xfa8fd5a0081c0288ULL, -1220, -348}, {0xbaaee17fa23ebf76ULL, -1193, -340},
+    {0x8b16fb203055ac76ULL, -1166, -332}, {0xcf42894a5dce35eaULL, -1140, -324},
+    {0x9a6bb0aa55653b2dULL, -1113, -316}, {0xe61acf033d1a45dfULL, -1087, -308},
+    {0xab70fe17c79ac6caULL, -1060, -300}, {0xff77b1fcbebcdc4fULL, -1034, -292},
+    {0xbe5691ef416bd60cULL, -1007, -284}, {0x8dd01fad907ffc3cULL, -980, -276},
+    {0xd3515c2831559a83ULL, -954, -268}, {0x9d71ac8fada6c9b5ULL, -927, -260},
+    {0xea9c227723ee8bcbULL, -901, -252}, {0xaecc49914078536dULL, -874, -244},
+    {0x823c12795db6ce57ULL, -847, -236}, {0xc21094364dfb5637ULL, -821, -228},
+    {0x9096ea6f3848984fULL, -794, -220}, {0xd77485cb25823ac7ULL, -768, -212},
+    {0xa086cfcd97bf97f4ULL, -741, -204}, {0xef340a98172aace5ULL, -715, -196},
+    {0xb23867fb2a35b28eULL, -688, -188}, {0x84c8d4dfd2c63f3bULL, -661, -180},
+    {0xc5dd44271ad3cdbaULL, -635, -172}, {0x936b9fcebb25c996ULL, -608, -164},
+    {0xdbac6c247d62a584ULL, -582, -156}, {0xa3ab66580d5fdaf6ULL, -555, -148},
+    {0xf3e2f893dec3f126ULL, -529, -140}, {0xb5b5ada8aaff80b8ULL, -502, -132},
+    {0x87625f056c7c4a8bULL, -475, -124}, {0xc9bcff6034c13053ULL, -449, -116},
+    {0x964e858c91ba2655ULL, -422, -108}, {0xdff9772470297ebdULL, -396, -100},
+    {0xa6dfbd9fb8e5b88fULL, -369, -92}, {0xf8a95fcf88747d94ULL, -343, -84},
+    {0xb94470938fa89bcfULL, -316, -76}, {0x8a08f0f8bf0f156bULL, -289, -68},
+    {0xcdb02555653131b6ULL, -263, -60}, {0x993fe2c6d07b7facULL, -236, -52},
+    {0xe45c10c42a2b3b06ULL, -210, -44}, {0xaa242499697392d3ULL, -183, -36},
+    {0xfd87b5f28300ca0eULL, -157, -28}, {0xbce5086492111aebULL, -130, -20},
+    {0x8cbccc096f5088ccULL, -103, -12}, {0xd1b71758e219652cULL, -77, -4},
+    {0x9c40000000000000ULL, -50, 4}, {0xe8d4a51000000000ULL, -24, 12},
+    {0xad78ebc5ac620000ULL, 3, 20}, {0x813f3978f8940984ULL, 30, 28},
+    {0xc097ce7bc90715b3ULL, 56, 36}, {0x8f7e32ce7bea5c70ULL, 83, 44},
+    {0xd5d238a4abe98068ULL, 109, 52}, {0x9f4f2726179a2245ULL, 136, 60},
+    {0xed63a231d4c4fb27ULL, 162, 68}, {0xb0de65388cc8ada8ULL, 189, 76},
+    {0x83c7088e1aab65dbULL, 216, 84}, {0xc45d1df942711d9aULL, 242, 92},
+    {0x924d692ca61be758ULL, 269, 100}, {0xda01ee641a708deaULL, 295, 108},
+    {0xa26da3999aef774aULL, 322, 116}, {0xf209787bb47d6b85ULL, 348, 124},
+    {0xb454e4a179dd1877ULL, 375, 132}, {0x865b86925b9bc5c2ULL, 402, 140},
+    {0xc83553c5c8965d3dULL, 428, 148}, {0x952ab45cfa97a0b3ULL, 455, 156},
+    {0xde469fbd99a05fe3ULL, 481, 164}, {0xa59bc234db398c25ULL, 508, 172},
+    {0xf6c69a72a3989f5cULL, 534, 180}, {0xb7dcbf5354e9beceULL, 561, 188},
+    {0x88fcf317f22241e2ULL, 588, 196}, {0xcc20ce9bd35c78a5ULL, 614, 204},
+    {0x98165af37b2153dfULL, 641, 212}, {0xe2a0b5dc971f303aULL, 667, 220},
+    {0xa8d9d1535ce3b396ULL, 694, 228}, {0xfb9b7cd9a4a7443cULL, 720, 236},
+    {0xbb764c4ca7a44410ULL, 747, 244}, {0x8bab8eefb6409c1aULL, 774, 252},
+    {0xd01fef10a657842cULL, 800, 260}, {0x9b10a4e5e9913129ULL, 827, 268},
+    {0xe7109bfba19c0c9dULL, 853, 276}, {0xac2820d9623bf429ULL, 880, 284},
+    {0x80444b5e7aa7cf85ULL, 907, 292}, {0xbf21e44003acdd2dULL, 933, 300},
+    {0x8e679c2f5e44ff8fULL, 960, 308}, {0xd433179d9c8cb841ULL, 986, 316},
+    {0x9e19db92b4e31ba9ULL, 1013, 324}, {0xeb96bf6ebadf77d9ULL, 1039, 332},
+    {0xaf87023b9bf0ee6bULL, 1066, 340},
+};
+
+static const int cachedPowersOffset = 348;
+static const int cachedPowersDistance = 8;
+
+// The scaled numbers get an exponent in this range, leaving 32 bits for the integral digits
+static const int minimalTargetExponent = -60;
+static const int maximalTargetExponent = -32;
+
+static const double exactPowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static _DiyFp multiply(_DiyFp x, _DiyFp y) {
+    // The upper half of the 128 bit product, rounded
+    const uint64_t mask = 0xffffffff;
+    uint64_t a = x.f >> 32, b = x.f & mask, c = y.f >> 32, d = y.f & mask;
+    uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    uint64_t middle = (bd >> 32) + (ad & mask) + (bc & mask) + (1ULL << 31);
+    _DiyFp product = { ac + (ad >> 32) + (bc >> 32) + (middle >> 32), x.e + y.e + 64 };
+    return product;
+}
+
+static _DiyFp normalize(_DiyFp x) {
+    while (!(x.f & (1ULL << 63))) {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+// Moves the last digit towards w as long as that stays within the interval.
+// Fails if the result cannot be told apart from its neighbours with the precision at hand.
+static bool roundWeed(char* digits, int length, uint64_t distanceTooHighW, uint64_t unsafeInterval, uint64_t rest, uint64_t tenKappa, uint64_t unit) {
+    uint64_t smallDistance = distanceTooHighW - unit;
+    uint64_t bigDistance = distanceTooHighW + unit;
+    while (rest < smallDistance && unsafeInterval - rest >= tenKappa
+        && (rest + tenKappa < smallDistance || smallDistance - rest >= rest + tenKappa - smallDistance)) {
+        digits[length - 1]--;
+        rest += tenKappa;
+    }
+
+    if (rest < bigDistance && unsafeInterval - rest >= tenKappa
+        && (rest + tenKappa < bigDistance || bigDistance - rest > rest + tenKappa - bigDistance))
+        return false;
+
+    return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+}
+
+// Generates the shortest digits between low and high, the scaled boundaries of w
+static bool generateDigits(_DiyFp low, _DiyFp w, _DiyFp high, char* digits, int* length, int* kappa) {
+    uint64_t unit = 1;
+    _DiyFp tooLow = { low.f - unit, low.e };
+    _DiyFp tooHigh = { high.f + unit, high.e };
+    uint64_t unsafeInterval = tooHigh.f - tooLow.f;
+    int shift = -w.e;
+    uint64_t one = 1ULL << shift;
+    uint32_t integrals = (uint32_t)(tooHigh.f >> shift);
+    uint64_t fractionals = tooHigh.f & (one - 1);
+
+    uint32_t divisor = 1;
+    *kappa = 1;
+    while (integrals / divisor >= 10) {
+        divisor *= 10;
+        (*kappa)++;
+    }
+
+    *length = 0;
+    while (*kappa > 0) {
+        digits[(*length)++] = '0' + integrals / divisor;
+        integrals %= divisor;
+        (*kappa)--;
+        uint64_t rest = ((uint64_t)integrals << shift) + fractionals;
+        if (rest < unsafeInterval)
+            return roundWeed(digits, *length, tooHigh.f - w.f, unsafeInterval, rest, (uint64_t)divisor << shift, unit);
+
+        divisor /= 10;
+    }
+
+    for (;;) {
+        fractionals *= 10;
+        unit *= 10;
+        unsafeInterval *= 10;
+        digits[(*length)++] = '0' + (int)(fractionals >> shift);
+        fractionals &= one - 1;
+        (*kappa)--;
+        if (fractionals < unsafeInterval)
+            return roundWeed(digits, *length, (tooHigh.f - w.f) * unit, unsafeInterval, fractionals, one, unit);
+    }
+}
+
+// The shortest digits of a positive finite number, which is digits * 10^exponent
+static bool grisu3(double number, char* digits, int* length, int* exponent) {
+    uint64_t bits;
+    memcpy(&bits, &number, sizeof(bits));
+    const uint64_t hiddenBit = 1ULL << 52;
+    uint64_t significand = bits & (hiddenBit - 1);
+    int biasedExponent = (int)(bits >> 52);
+    _DiyFp v;
+    if (biasedExponent) {
+        v.f = significand | hiddenBit;
+        v.e = biasedExponent - 1075;
+    }
+    else {
+        v.f = significand;
+        v.e = -1074;
+    }
+
+    // The boundaries are halfway to the neighbours, and the lower one is closer at a power of 2
+    _DiyFp plus = { (v.f << 1) + 1, v.e - 1 };
+    plus = normalize(plus);
+    _DiyFp minus;
+    if (!significand && biasedExponent > 1) {
+        minus.f = (v.f << 2) - 1;
+        minus.e = v.e - 2;
+    }
+    else {
+        minus.f = (v.f << 1) - 1;
+        minus.e = v.e - 1;
+    }
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+    _DiyFp w = normalize(v);
+
+    // Scale by a cached power of ten into the target exponent range
+    int k = (int)ceil((minimalTargetExponent - (w.e + 64) + 63) * 0.30102999566398114);
+    const _CachedPower& cached = cachedPowers[(cachedPowersOffset + k - 1) / cachedPowersDistance + 1];
+    _DiyFp power = { cached.significand, cached.binaryExponent };
+
+    int kappa;
+    bool found = generateDigits(multiply(minus, power), multiply(w, power), multiply(plus, power), digits, length, &kappa);
+    *exponent = kappa - cached.decimalExponent;
+    return found;
+}
+
+// The rare numbers grisu3 fails on take the first precision which reads back
+static void findShortestDigits(double number, char* digits, int* length, int* exponent) {
+    char text[Number::maxLength];
+    for (int precision = 1; precision <= 17; precision++) {
+        snprintf(text, sizeof(text), "%.*e", precision - 1, number);
+        if (precision == 17 || strtod(text, 0) == number)
+            break;
+    }
+
+    // The text looks like d.ddde-xx
+    *length = 0;
+    char* c = text;
+    for (; *c != 'e'; c++) {
+        if (*c != '.')
+            digits[(*length)++] = *c;
+    }
+    *exponent = atoi(c + 1) - (*length - 1);
+}
+
+char* Number::writeDecimal(char* first, size_t number) {
+    size_t digits = 1;
+    for (size_t rest = number; rest >= 10; rest /= 10)
+        digits++;
+
+    char* end = first + digits;
+    _writeDecimal(end, number);
+    return end;
+}
+
+char* Number::writeSigned(char* first, long long number) {
+    if (number < 0) {
+        *first++ = '-';
+        // Negate in unsigned arithmetic, which also works for the smallest number
+        return writeDecimal(first, 0 - (unsigned long long)number);
+    }
+
+    return writeDecimal(first, number);
+}
+
+char* Number::writeHex(char* first, size_t number) {
+    size_t digits = 1;
+    for (size_t rest = number; rest >= 16; rest >>= 4)
+        digits++;
+
+    char* end = first + digits;
+    char* digit = end;
+    do {
+        *--digit = "0123456789abcdef"[number & 0xf];
+        number >>= 4;
+    }
+    while (number);
+
+    return end;
+}
+
+char* Number::writeFloat(char* first, double number) {
+    if (number != number) {
+        memcpy(first, "nan", 3);
+        return first + 3;
+    }
+
+    if (signbit(number)) {
+        *first++ = '-';
+        number = -number;
+    }
+
+    if (number == 0) {
+        *first = '0';
+        return first + 1;
+    }
+
+    if (isinf(number)) {
+        memcpy(first, "inf", 3);
+        return first + 3;
+    }
+
+    char digits[18];
+    int length;
+    int exponent;
+    if (!grisu3(number, digits, &length, &exponent))
+        findShortestDigits(number, digits, &length, &exponent);
+
+    // Where the decimal point goes, counted from the first digit
+    int point = length + exponent;
+    if (point > -4 && point <= 17) {
+        if (point <= 0) {
+            // Like 0.00123
+            *first++ = '0';
+            *first++ = '.';
+            memset(first, '0', -point);
+            first += -point;
+            memcpy(first, digits, length);
+            return first + length;
+        }
+
+        if (point >= length) {
+            // Like 12300
+            memcpy(first, digits, length);
+            memset(first + length, '0', point - length);
+            return first + point;
+        }
+
+        // Like 12.3
+        memcpy(first, digits, point);
+        first[point] = '.';
+        memcpy(first + point + 1, digits + point, length - point);
+        return first + length + 1;
+    }
+
+    // Like 1.23e+45, with at least two exponent digits as printf does
+    *first++ = digits[0];
+    if (length > 1) {
+        *first++ = '.';
+        memcpy(first, digits + 1, length - 1);
+        first += length - 1;
+    }
+    *first++ = 'e';
+    int scientific = point - 1;
+    if (scientific < 0) {
+        *first++ = '-';
+        scientific = -scientific;
+    }
+    else {
+        *first++ = '+';
+    }
+    if (scientific < 10)
+        *first++ = '0';
+
+    return writeDecimal(first, scientific);
+}
+
+bool Number::parseDecimal(_Slice text, size_t* number) {
+    if (text.isEmpty())
+        return false;
+
+    const size_t limit = (size_t)-1 / 10;
+    const size_t lastDigit = (size_t)-1 % 10;
+    size_t value = 0;
+    for (size_t i = 0; i < text.getLength(); i++) {
+        size_t digit = (unsigned char)text[i] - '0';
+        if (digit > 9)
+            return false;
+
+        if (value >= limit && (value > limit || digit > lastDigit))
+            return false;
+
+        value = value * 10 + digit;
+    }
+
+    *number = value;
+    return true;
+}
+
+bool Number::parseSigned(_Slice text, long long* number) {
+    bool negative = !text.isEmpty() && text[0] == '-';
+    if (negative || (!text.isEmpty() && text[0] == '+'))
+        text = text.sub(1);
+
+    size_t magnitude;
+    if (!parseDecimal(text, &magnitude))
+        return false;
+
+    // The smallest number has no positive counterpart
+    const size_t largest = 9223372036854775807ULL;
+    if (magnitude > largest + negative)
+        return false;
+
+    *number = negative ? -(long long)(magnitude - 1) - 1 : (long long)magnitude;
+    return true;
+}
+
+bool Number::parseHex(_Slice text, size_t* number) {
+    if (text.isEmpty())
+        return false;
+
+    size_t value = 0;
+    for (size_t i = 0; i < text.getLength(); i++) {
+        char c = text[i];
+        size_t digit;
+        if (c >= '0' && c <= '9')
+            digit = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            digit = c - 'A' + 10;
+        else
+            return false;
+
+        if (value >> (sizeof(size_t) * 8 - 4))
+            return false;
+
+        value = (value << 4) | digit;
+    }
+
+    *number = value;
+    return true;
+}
+
+bool Number::parseFloat(_Slice text, double* number) {
+    // Check the syntax first, so that strtod cannot pick up hex, inf or nan.
+    // Meanwhile collect up to 19 significant digits and the decimal exponent.
+    size_t length = text.getLength();
+    size_t i = 0;
+    bool negative = i < length && text[i] == '-';
+    if (i < length && (text[i] == '-' || text[i] == '+'))
+        i++;
+
+    uint64_t significand = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    size_t digits = 0;
+    bool fraction = false;
+    for (; i < length; i++) {
+        char c = text[i];
+        if (c == '.' && !fraction) {
+            fraction = true;
+            continue;
+        }
+        if (c < '0' || c > '9')
+            break;
+
+        digits++;
+        if (significantDigits < 19) {
+            if (significand || c != '0') {
+                significand = significand * 10 + (c - '0');
+                significantDigits++;
+            }
+            if (fraction)
+                exponent--;
+        }
+        else if (!fraction) {
+            exponent++;
+        }
+    }
+    if (!digits)
+        return false;
+
+    if (i < length && (text[i] == 'e' || text[i] == 'E')) {
+        i++;
+        bool negativeExponent = i < length && text[i] == '-';
+        if (i < length && (text[i] == '-' || text[i] == '+'))
+            i++;
+
+        int explicitExponent = 0;
+        size_t exponentDigits = 0;
+        for (; i < length && text[i] >= '0' && text[i] <= '9'; i++) {
+            // Far beyond any double, but safe from int overflow
+            if (explicitExponent < 100000)
+                explicitExponent = explicitExponent * 10 + (text[i] - '0');
+            exponentDigits++;
+        }
+        if (!exponentDigits)
+            return false;
+
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+    if (i != length)
+        return false;
+
+    // Both the significand and the power of ten are exact doubles, and so is
+    // the correctly rounded result of a single multiplication or division
+    if (significantDigits < 19 && significand < (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+        double value = (double)significand;
+        value = exponent < 0 ? value / exactPowersOfTen[-exponent] : value * exactPowersOfTen[exponent];
+        *number = negative ? -value : value;
+        return true;
+    }
+
+    // strtod needs a trailing 0, which a slice may not have
+    char buffer[64];
+    if (length < sizeof(buffer))
+        return convertFloat(text, buffer, number);
+
+    _Region _region; _Page* _p = _region.get();
+    return convertFloat(text, (char*)_p->allocateObject(length + 1), number);
+}
+
+bool Number::convertFloat(_Slice text, char* buffer, double* number) {
+    memcpy(buffer, text.getData(), text.getLength());
+    buffer[text.getLength()] = 0;
+    errno = 0;
+    double value = strtod(buffer, 0);
+    if (errno == ERANGE && isinf(value))
+        return false;
+
+    *number = value;
+    return true;
+}
+
 string* Number::toString(_Page* _rp, size_t theNumber) {
-    char buf[255] = "";
-    snprintf(buf, sizeof buf, "%zu", theNumber);
-    return new(_rp) string(buf);
+    char digits[maxLength];
+    return new(_rp) string(digits, writeDecimal(digits, theNumber) - digits);
 }
 
 }
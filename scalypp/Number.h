@@ -2,9 +2,32 @@
 #define __Scaly__Number__
 namespace scaly {
 
+// Formatting and parsing of numbers without intermediate strings.
+// The write functions put the text at first and return its end. They need room
+// for maxLength chars, and they don't write a trailing 0.
+// The parse functions only succeed if the whole text is a number which fits.
 class Number {
 public:
+    static const size_t maxLength = 32;
+
+    static char* writeDecimal(char* first, size_t number);
+    static char* writeSigned(char* first, long long number);
+    static char* writeHex(char* first, size_t number);
+
+    // The shortest text which reads back as the same double
+    static char* writeFloat(char* first, double number);
+
+    static bool parseDecimal(_Slice text, size_t* number);
+    static bool parseSigned(_Slice text, long long* number);
+    static bool parseHex(_Slice text, size_t* number);
+
+    // Finite numbers like 42, -1.5 or 6.02e23, without inf and nan
+    static bool parseFloat(_Slice text, double* number);
+
     static string* toString(_Page* _rp, size_t theNumber);
+
+private:
+    static bool convertFloat(_Slice text, char* buffer, double* number);
 };
 
 }
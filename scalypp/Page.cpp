@@ -70,9 +70,11 @@ void* _Page::allocateObject(size_t size) {
             return extensionPage->allocateObject(size);
         }
 
-        // We allocate oversized objects directly.
+        // We allocate oversized objects directly, but never smaller than a page
+        // since reset writes the extension page location at the end of one.
         _Page* page;
-        posix_memalign((void**)&page, _pageSize, size + sizeof(_Page));
+        size_t pageSize = size + sizeof(_Page);
+        posix_memalign((void**)&page, _pageSize, pageSize < _pageSize ? _pageSize : pageSize);
         page->reset();
         page->currentPage = nullptr;
         *getNextExclusivePageLocation() = page;
@@ -95,37 +97,40 @@ _Page* _Page::allocateExtensionPage() {
 }
 
 _Page* _Page::allocateExclusivePage() {
+    _Page* exclusivePage = __CurrentTask->getExtensionPage();
+    if (!exclusivePage)
+        return 0;
+
+    exclusivePage->reset();
+    adoptExclusivePage(exclusivePage);
+    return exclusivePage;
+}
+
+void _Page::adoptExclusivePage(_Page* page) {
     if (this != currentPage) {
         // We're already known to be full, so we delegate to the current page
-        return currentPage->allocateExclusivePage();
+        currentPage->adoptExclusivePage(page);
+        return;
     }
 
-    // Check first whether we need an ordinary extension
+    // Check first whether we need an ordinary extension to store the page pointer
     if ((_Page**)getNextObject() >= getNextExclusivePageLocation()) {
-        // Allocate an extension page with default size
-        allocateExtensionPage()->allocateExclusivePage();
+        allocateExtensionPage()->adoptExclusivePage(page);
+        return;
     }
 
-    _Page* exclusivePage = __CurrentTask->getExtensionPage();
-    if (!exclusivePage)
-        return 0;
-
-    exclusivePage->reset();
-    *getNextExclusivePageLocation() = exclusivePage;
+    *getNextExclusivePageLocation() = page;
     exclusivePages++;
-    return exclusivePage;
 }
 
 bool _Page::extend(void* address, size_t size) {
-    if (!size)
-        size = 1;
+    // Only the object allocated last can grow, so it has to end where the next object would start
+    if (align((char*) address) != getNextObject())
+        return false;
     void* nextLocation = align((char*) address + size);
     // If nextObject would not change because of the alignment, that's it
     if (nextLocation == (void*)getNextObject())
         return true;
-    // If nextObject is already higher, other objects were allocated in the meantime
-    if (nextLocation < getNextObject())
-        return false;
     // Now we still have to check whether we still would have space left
     if (nextLocation >= (void*) getNextExclusivePageLocation())
         return false;
@@ -155,15 +160,33 @@ void _Page::forget(_Page* page) {
 }
 
 bool _Page::reclaimArray(void* address) {
-    // Quick attempt to find it at tue current page
-    if (currentPage->deallocateExclusivePage((_Page*)address))
+    // The array sits right after the header of its oversized page
+    _Page* arrayPage = getPage(address);
+    if (!releaseExclusivePage(arrayPage))
+        // If we arrive here, we have a memory leak.
+        return false;
+
+    forget(arrayPage);
+    return true;
+}
+
+bool _Page::handOverExclusivePage(_Page* page, _Page* newOwner) {
+    if (!releaseExclusivePage(page))
+        return false;
+
+    newOwner->adoptExclusivePage(page);
+    return true;
+}
+
+bool _Page::releaseExclusivePage(_Page* page) {
+    // Quick attempt to find it at the current page
+    if (currentPage->unlinkExclusivePage(page))
         return true;
     // Second attempt scanning the rest of the chain
-    for (_Page* page = this; page != currentPage; page = *page->getExtensionPageLocation())
-        if (page->deallocateExclusivePage((_Page*)address))
+    for (_Page* extensionPage = this; extensionPage != currentPage; extensionPage = *extensionPage->getExtensionPageLocation())
+        if (extensionPage->unlinkExclusivePage(page))
             return true;
-    
-    // If we arrive here, we have a memory leak.
+
     return false;
 }
 
@@ -171,7 +194,7 @@ _Page* _Page::getPage(void* address) {
     return (_Page*) (((intptr_t)address) & ~(intptr_t)(_pageSize - 1));
 }
 
-bool _Page::deallocateExclusivePage(_Page* _page) {
+bool _Page::unlinkExclusivePage(_Page* _page) {
     // Find the extension Page pointer
     _Page** ppPage = getExtensionPageLocation() - 1;
     _Page** nextExtensionPageLocation = getNextExclusivePageLocation();
@@ -190,7 +213,6 @@ bool _Page::deallocateExclusivePage(_Page* _page) {
         *ppPage = *(ppPage - 1);
     // Make room for one more extension
     exclusivePages--;
-    forget(_page);
     return true;
 }
 
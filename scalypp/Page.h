@@ -8,9 +8,11 @@ public:
     void clear();
     void* allocateObject(size_t size);
     _Page* allocateExclusivePage();
+    void adoptExclusivePage(_Page* page);
     static void forget(_Page* page);
     void deallocateExtensions();
     bool reclaimArray(void* address);
+    bool handOverExclusivePage(_Page* page, _Page* newOwner);
     static _Page* getPage(void* address);
     bool extend(void* address, size_t size);
     bool isOversized();
@@ -18,7 +20,8 @@ public:
 private:
     _Page* allocateExtensionPage();
     _Page** getExtensionPageLocation();
-    bool deallocateExclusivePage(_Page* page);
+    bool releaseExclusivePage(_Page* page);
+    bool unlinkExclusivePage(_Page* page);
     void* getNextObject();
     void setNextObject(void* object);
     _Page** getNextExclusivePageLocation();
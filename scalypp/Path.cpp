@@ -2,29 +2,35 @@
 namespace scaly {
 
 string* Path::getFileNameWithoutExtension(_Page* _rp, string* path) {
-    string* fileName = getFileName(_rp, path);
-    if (!fileName)
+    _Slice fileName;
+    if (!getFileName(path, &fileName))
         return 0;
-    
-    _Array<string>& fileNameComponents = fileName->Split(_rp, '.');
-    size_t fileNameComponentsLength = fileNameComponents.length();
-    if (fileNameComponentsLength == 1)
-        return new(_rp) string(path);
-        
-    VarString* ret = new(_rp) VarString();
-    for (size_t _i = 0; _i < fileNameComponentsLength - 1; _i++)
-        ret->append(*fileNameComponents[_i]);
-        
-    return new(_rp) string(ret);
+
+    size_t dot = fileName.findLast('.');
+    if (dot != _Slice::notFound && dot > 0)
+        fileName = fileName.sub(0, dot);
+
+    return fileName.toString(_rp);
 }
 
 string* Path::getFileName(_Page* _rp, string* path) {
-    if (!path->getLength())
+    _Slice fileName;
+    if (!getFileName(path, &fileName))
         return 0;
-    if (path->charAt(path->getLength() - 1) == '/')
-        return 0;
-    _Array<string>& pathComponents = path->Split(_rp, '/');
-    return *pathComponents[pathComponents.length() - 1];
+
+    return fileName.toString(_rp);
+}
+
+bool Path::getFileName(string* path, _Slice* fileName) {
+    _Slice slice(path);
+    if (slice.isEmpty())
+        return false;
+    if (slice[slice.getLength() - 1] == '/')
+        return false;
+
+    size_t slash = slice.findLast('/');
+    *fileName = slash == _Slice::notFound ? slice : slice.sub(slash + 1);
+    return true;
 }
 
 }
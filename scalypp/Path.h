@@ -6,6 +6,10 @@ class Path {
 public:
     static string* getFileNameWithoutExtension(_Page* _rp, string* path);
     static string* getFileName(_Page* _rp, string* path);
+
+private:
+    // The part of path after the last slash, without copying
+    static bool getFileName(string* path, _Slice* fileName);
 };
 
 }
@@ -0,0 +1,287 @@
+#ifndef __Scaly__PersistentHashMap__
+#define __Scaly__PersistentHashMap__
+#include "Scaly.h"
+namespace scaly {
+
+// An immutable hash map keyed by strings which is updated by making new versions.
+// It is a hash array mapped trie: each node takes 5 bits of the hash and keeps
+// bitmaps of the slots holding an entry and of those holding a sub node, so a
+// node is only as large as its contents. A new version copies the path to the
+// changed entry and shares all other nodes with the old one. Since no version
+// changes after it is made, a version can be read by any number of tasks while
+// a writer makes new versions on its own page.
+// K has to provide getNativeString, getLength and getHash like string and VarString do.
+template<class K, class V> class _PersistentHashMap : public Object {
+public:
+    _PersistentHashMap<K, V>()
+    : _size(0), _root(0) {}
+
+    size_t length() {
+        return _size;
+    }
+
+    // The value of a key, or 0 if it is not present
+    V* get(K* key) {
+        _Entry* entry = find(key->getNativeString(), key->getLength(), key->getHash());
+        return entry ? entry->value : 0;
+    }
+
+    // The value of the key spelled by length bytes at data, or 0 if it is not present
+    V* get(const char* data, size_t length) {
+        _Entry* entry = find(data, length, Hash::of(data, length));
+        return entry ? entry->value : 0;
+    }
+
+    bool contains(K* key) {
+        return find(key->getNativeString(), key->getLength(), key->getHash()) != 0;
+    }
+
+    // A new version on _rp where key maps to value
+    _PersistentHashMap<K, V>* insert(_Page* _rp, K* key, V* value) {
+        _Entry entry = { key->getHash(), key, value };
+        bool added = false;
+        _Node* root = insertInto(_rp, _root, 0, entry, &added);
+        return new(_rp) _PersistentHashMap<K, V>(_size + added, root);
+    }
+
+    // A new version on _rp without key, or this if key is not present
+    _PersistentHashMap<K, V>* remove(_Page* _rp, K* key) {
+        if (!contains(key))
+            return this;
+
+        _Node* root = removeFrom(_rp, _root, 0, key->getNativeString(), key->getLength(), key->getHash());
+        return new(_rp) _PersistentHashMap<K, V>(_size - 1, root);
+    }
+
+private:
+    static const size_t bits = 5;
+    static const size_t mask = (1 << bits) - 1;
+
+    struct _Entry {
+        size_t hash;
+        K* key;
+        V* value;
+    };
+
+    // The entries follow the node, then the sub nodes. Where the hash bits run out,
+    // a collision node holds all entries with the same hash and no bitmaps.
+    struct _Node {
+        uint32_t entryMap;
+        uint32_t nodeMap;
+        size_t collisions;
+    };
+
+    _PersistentHashMap<K, V>(size_t size, _Node* root)
+    : _size(size), _root(root) {}
+
+    static size_t entryCount(_Node* node) {
+        return node->collisions ? node->collisions : _popCount(node->entryMap);
+    }
+
+    static _Entry* entries(_Node* node) {
+        return (_Entry*)(node + 1);
+    }
+
+    static _Node** nodes(_Node* node) {
+        return (_Node**)(entries(node) + entryCount(node));
+    }
+
+    static uint32_t bitOf(size_t hash, size_t shift) {
+        return (uint32_t)1 << ((hash >> shift) & mask);
+    }
+
+    // The position of bit among the set bits of map
+    static size_t indexOf(uint32_t map, uint32_t bit) {
+        return _popCount(map & (bit - 1));
+    }
+
+    static bool matches(_Entry* entry, const char* data, size_t length, size_t hash) {
+        return entry->hash == hash && entry->key->getLength() == length &&
+            (entry->key->getNativeString() == data || !memcmp(entry->key->getNativeString(), data, length));
+    }
+
+    static _Node* allocateNode(_Page* page, uint32_t entryMap, uint32_t nodeMap, size_t collisions) {
+        size_t entryCount = collisions ? collisions : _popCount(entryMap);
+        _Node* node = (_Node*)page->allocateObject(sizeof(_Node) + entryCount * sizeof(_Entry) + _popCount(nodeMap) * sizeof(_Node*));
+        node->entryMap = entryMap;
+        node->nodeMap = nodeMap;
+        node->collisions = collisions;
+        return node;
+    }
+
+    _Entry* find(const char* data, size_t length, size_t hash) {
+        _Node* node = _root;
+        for (size_t shift = 0; node; shift += bits) {
+            if (node->collisions) {
+                for (size_t i = 0; i < node->collisions; i++) {
+                    if (matches(entries(node) + i, data, length, hash))
+                        return entries(node) + i;
+                }
+                return 0;
+            }
+
+            uint32_t bit = bitOf(hash, shift);
+            if (node->entryMap & bit) {
+                _Entry* entry = entries(node) + indexOf(node->entryMap, bit);
+                return matches(entry, data, length, hash) ? entry : 0;
+            }
+            if (!(node->nodeMap & bit))
+                return 0;
+
+            node = nodes(node)[indexOf(node->nodeMap, bit)];
+        }
+
+        return 0;
+    }
+
+    static _Node* insertInto(_Page* page, _Node* node, size_t shift, _Entry& entry, bool* added) {
+        const char* data = entry.key->getNativeString();
+        size_t length = entry.key->getLength();
+        if (!node) {
+            *added = true;
+            _Node* leaf = allocateNode(page, bitOf(entry.hash, shift), 0, 0);
+            entries(leaf)[0] = entry;
+            return leaf;
+        }
+
+        if (node->collisions) {
+            size_t i = 0;
+            while (i < node->collisions && !matches(entries(node) + i, data, length, entry.hash))
+                i++;
+            *added = i == node->collisions;
+            _Node* copy = allocateNode(page, 0, 0, node->collisions + *added);
+            memcpy(entries(copy), entries(node), node->collisions * sizeof(_Entry));
+            entries(copy)[i] = entry;
+            return copy;
+        }
+
+        uint32_t bit = bitOf(entry.hash, shift);
+        if (node->entryMap & bit) {
+            size_t i = indexOf(node->entryMap, bit);
+            _Entry* existing = entries(node) + i;
+            if (matches(existing, data, length, entry.hash)) {
+                _Node* copy = copyNode(page, node);
+                entries(copy)[i] = entry;
+                return copy;
+            }
+
+            // Both entries move down into a new sub node
+            *added = true;
+            _Node* child = mergeEntries(page, *existing, entry, shift + bits);
+            _Node* copy = allocateNode(page, node->entryMap ^ bit, node->nodeMap | bit, 0);
+            size_t entryCount = _popCount(node->entryMap);
+            memcpy(entries(copy), entries(node), i * sizeof(_Entry));
+            memcpy(entries(copy) + i, entries(node) + i + 1, (entryCount - i - 1) * sizeof(_Entry));
+            size_t j = indexOf(node->nodeMap, bit);
+            size_t nodeCount = _popCount(node->nodeMap);
+            memcpy(nodes(copy), nodes(node), j * sizeof(_Node*));
+            nodes(copy)[j] = child;
+            memcpy(nodes(copy) + j + 1, nodes(node) + j, (nodeCount - j) * sizeof(_Node*));
+            return copy;
+        }
+
+        if (node->nodeMap & bit) {
+            size_t j = indexOf(node->nodeMap, bit);
+            _Node* copy = copyNode(page, node);
+            nodes(copy)[j] = insertInto(page, nodes(node)[j], shift + bits, entry, added);
+            return copy;
+        }
+
+        *added = true;
+        _Node* copy = allocateNode(page, node->entryMap | bit, node->nodeMap, 0);
+        size_t i = indexOf(node->entryMap, bit);
+        size_t entryCount = _popCount(node->entryMap);
+        memcpy(entries(copy), entries(node), i * sizeof(_Entry));
+        entries(copy)[i] = entry;
+        memcpy(entries(copy) + i + 1, entries(node) + i, (entryCount - i) * sizeof(_Entry));
+        memcpy(nodes(copy), nodes(node), _popCount(node->nodeMap) * sizeof(_Node*));
+        return copy;
+    }
+
+    // A node holding two entries whose hashes agree below shift
+    static _Node* mergeEntries(_Page* page, _Entry& first, _Entry& second, size_t shift) {
+        if (shift >= sizeof(size_t) * 8) {
+            _Node* node = allocateNode(page, 0, 0, 2);
+            entries(node)[0] = first;
+            entries(node)[1] = second;
+            return node;
+        }
+
+        uint32_t firstBit = bitOf(first.hash, shift);
+        uint32_t secondBit = bitOf(second.hash, shift);
+        if (firstBit == secondBit) {
+            _Node* node = allocateNode(page, 0, firstBit, 0);
+            nodes(node)[0] = mergeEntries(page, first, second, shift + bits);
+            return node;
+        }
+
+        _Node* node = allocateNode(page, firstBit | secondBit, 0, 0);
+        entries(node)[firstBit < secondBit ? 0 : 1] = first;
+        entries(node)[firstBit < secondBit ? 1 : 0] = second;
+        return node;
+    }
+
+    // Only called if the key is present. Returns 0 if the node becomes empty.
+    static _Node* removeFrom(_Page* page, _Node* node, size_t shift, const char* data, size_t length, size_t hash) {
+        if (node->collisions) {
+            _Node* copy = allocateNode(page, 0, 0, node->collisions - 1);
+            _Entry* entry = entries(copy);
+            for (size_t i = 0; i < node->collisions; i++) {
+                if (!matches(entries(node) + i, data, length, hash))
+                    *entry++ = entries(node)[i];
+            }
+            return copy;
+        }
+
+        uint32_t bit = bitOf(hash, shift);
+        if (node->entryMap & bit) {
+            if (entryCount(node) == 1 && !node->nodeMap)
+                return 0;
+
+            _Node* copy = allocateNode(page, node->entryMap ^ bit, node->nodeMap, 0);
+            size_t i = indexOf(node->entryMap, bit);
+            size_t entryCount = _popCount(node->entryMap);
+            memcpy(entries(copy), entries(node), i * sizeof(_Entry));
+            memcpy(entries(copy) + i, entries(node) + i + 1, (entryCount - i - 1) * sizeof(_Entry));
+            memcpy(nodes(copy), nodes(node), _popCount(node->nodeMap) * sizeof(_Node*));
+            return copy;
+        }
+
+        size_t j = indexOf(node->nodeMap, bit);
+        _Node* child = removeFrom(page, nodes(node)[j], shift + bits, data, length, hash);
+        if (child && (child->nodeMap || entryCount(child) > 1)) {
+            _Node* copy = copyNode(page, node);
+            nodes(copy)[j] = child;
+            return copy;
+        }
+
+        // A sub node left with a single entry is folded into this node
+        if (!child && entryCount(node) == 0 && _popCount(node->nodeMap) == 1)
+            return 0;
+
+        _Node* copy = allocateNode(page, child ? node->entryMap | bit : node->entryMap, node->nodeMap ^ bit, 0);
+        size_t i = indexOf(node->entryMap, bit);
+        size_t entryCount = _popCount(node->entryMap);
+        memcpy(entries(copy), entries(node), i * sizeof(_Entry));
+        if (child)
+            entries(copy)[i] = entries(child)[0];
+        memcpy(entries(copy) + i + (child ? 1 : 0), entries(node) + i, (entryCount - i) * sizeof(_Entry));
+        size_t nodeCount = _popCount(node->nodeMap);
+        memcpy(nodes(copy), nodes(node), j * sizeof(_Node*));
+        memcpy(nodes(copy) + j, nodes(node) + j + 1, (nodeCount - j - 1) * sizeof(_Node*));
+        return copy;
+    }
+
+    static _Node* copyNode(_Page* page, _Node* node) {
+        size_t size = sizeof(_Node) + entryCount(node) * sizeof(_Entry) + _popCount(node->nodeMap) * sizeof(_Node*);
+        _Node* copy = (_Node*)page->allocateObject(size);
+        memcpy(copy, node, size);
+        return copy;
+    }
+
+    size_t _size;
+    _Node* _root;
+};
+
+}
+#endif//__Scaly__PersistentHashMap__
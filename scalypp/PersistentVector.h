@@ -0,0 +1,154 @@
+#ifndef __Scaly__PersistentVector__
+#define __Scaly__PersistentVector__
+#include "Scaly.h"
+namespace scaly {
+
+// An immutable vector of pointers which is updated by making new versions.
+// The items live in a trie of 32 slot nodes plus a tail node for the last
+// items, like Clojure's vector. A new version copies only the path to the
+// changed item and shares all other nodes with the old one. Since no version
+// changes after it is made, a version can be read by any number of tasks
+// while a writer makes new versions on its own page.
+template<class T> class _PersistentVector : public Object {
+public:
+    _PersistentVector<T>()
+    : _size(0), _shift(bits), _root(0), _tail(0) {}
+
+    size_t length() {
+        return _size;
+    }
+
+    // The item at i, or 0 if i is out of range
+    T* get(size_t i) {
+        if (i >= _size)
+            return 0;
+
+        return (T*)getLeaf(i)->slots[i & mask];
+    }
+
+    // A new version on _rp with item appended
+    _PersistentVector<T>* push(_Page* _rp, T* item) {
+        size_t tailLength = _size - tailOffset();
+        if (tailLength < width) {
+            _Node* tail = copyNode(_rp, _tail);
+            tail->slots[tailLength] = item;
+            return new(_rp) _PersistentVector<T>(_size + 1, _shift, _root, tail);
+        }
+
+        // The tail is full and goes into the trie, which grows a level if it is full as well
+        _Node* root;
+        size_t shift = _shift;
+        if ((_size >> bits) > ((size_t)1 << _shift)) {
+            root = allocateNode(_rp);
+            root->slots[0] = _root;
+            root->slots[1] = newPath(_rp, _shift, _tail);
+            shift += bits;
+        }
+        else {
+            root = pushTail(_rp, _shift, _root, _tail);
+        }
+
+        _Node* tail = allocateNode(_rp);
+        tail->slots[0] = item;
+        return new(_rp) _PersistentVector<T>(_size + 1, shift, root, tail);
+    }
+
+    // A new version on _rp with the item at i replaced, or this if i is out of range
+    _PersistentVector<T>* set(_Page* _rp, size_t i, T* item) {
+        if (i >= _size)
+            return this;
+
+        if (i >= tailOffset()) {
+            _Node* tail = copyNode(_rp, _tail);
+            tail->slots[i & mask] = item;
+            return new(_rp) _PersistentVector<T>(_size, _shift, _root, tail);
+        }
+
+        return new(_rp) _PersistentVector<T>(_size, _shift, setInTrie(_rp, _shift, _root, i, item), _tail);
+    }
+
+private:
+    static const size_t bits = 5;
+    static const size_t width = 1 << bits;
+    static const size_t mask = width - 1;
+
+    struct _Node {
+        void* slots[width];
+    };
+
+    _PersistentVector<T>(size_t size, size_t shift, _Node* root, _Node* tail)
+    : _size(size), _shift(shift), _root(root), _tail(tail) {}
+
+    // The index of the first item in the tail
+    size_t tailOffset() {
+        return _size < width ? 0 : ((_size - 1) >> bits) << bits;
+    }
+
+    _Node* getLeaf(size_t i) {
+        if (i >= tailOffset())
+            return _tail;
+
+        _Node* node = _root;
+        for (size_t level = _shift; level > 0; level -= bits)
+            node = (_Node*)node->slots[(i >> level) & mask];
+
+        return node;
+    }
+
+    static _Node* allocateNode(_Page* page) {
+        _Node* node = (_Node*)page->allocateObject(sizeof(_Node));
+        memset(node, 0, sizeof(_Node));
+        return node;
+    }
+
+    static _Node* copyNode(_Page* page, _Node* node) {
+        if (!node)
+            return allocateNode(page);
+
+        _Node* copy = (_Node*)page->allocateObject(sizeof(_Node));
+        memcpy(copy, node, sizeof(_Node));
+        return copy;
+    }
+
+    // A chain of nodes down to level 0 which ends in node
+    static _Node* newPath(_Page* page, size_t level, _Node* node) {
+        if (!level)
+            return node;
+
+        _Node* path = allocateNode(page);
+        path->slots[0] = newPath(page, level - bits, node);
+        return path;
+    }
+
+    _Node* pushTail(_Page* page, size_t level, _Node* parent, _Node* tail) {
+        size_t i = ((_size - 1) >> level) & mask;
+        _Node* node = copyNode(page, parent);
+        if (level == bits) {
+            node->slots[i] = tail;
+        }
+        else {
+            _Node* child = parent ? (_Node*)parent->slots[i] : 0;
+            node->slots[i] = child ? pushTail(page, level - bits, child, tail) : newPath(page, level - bits, tail);
+        }
+
+        return node;
+    }
+
+    static _Node* setInTrie(_Page* page, size_t level, _Node* parent, size_t i, T* item) {
+        _Node* node = copyNode(page, parent);
+        if (!level)
+            node->slots[i & mask] = item;
+        else
+            node->slots[(i >> level) & mask] = setInTrie(page, level - bits, (_Node*)parent->slots[(i >> level) & mask], i, item);
+
+        return node;
+    }
+
+    size_t _size;
+    size_t _shift;
+    _Node* _root;
+    _Node* _tail;
+};
+
+}
+#endif//__Scaly__PersistentVector__
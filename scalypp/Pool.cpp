@@ -1,20 +1,62 @@
 #include "Scaly.h"
 namespace scaly{
 
-_Pool::_Pool() {
-    chunks = new(_getPage()) _Array<_Chunk>(); }
+_Pool::_Pool(int node)
+: chunks(0), chunksLength(0), chunksCapacity(0), node(node), next(this) {
+    pthread_mutex_init(&mutex, 0); }
+
+void* _Pool::operator new(size_t size, _Page* page) {
+    return alignToCacheLine((char*)Object::operator new(size + _cacheLineSize - _alignment, page)); }
+
+size_t _Pool::allocatePages(_Page** pages, size_t count) {
+    pthread_mutex_lock(&mutex);
+    size_t allocated = 0;
+    for (; allocated < count; allocated++) {
+        _Page* page = allocatePage();
+        if (!page)
+            break;
+        pages[allocated] = page; }
+    pthread_mutex_unlock(&mutex);
+    return allocated; }
+
+void _Pool::deallocatePages(_Page** pages, size_t count) {
+    deallocatePages(pages, count, this); }
+
+void _Pool::deallocatePages(_Page** pages, size_t count, _Pool* origin) {
+    // Pages of other pools are moved to the front and passed on
+    size_t foreign = 0;
+    pthread_mutex_lock(&mutex);
+    for (size_t i = 0; i < count; i++) {
+        if (!getContainingChunk(pages[i]))
+            pages[foreign++] = pages[i];
+        else
+            deallocatePage(pages[i]); }
+    pthread_mutex_unlock(&mutex);
+
+    if (foreign && next != origin)
+        next->deallocatePages(pages, foreign, origin); }
+
+void _Pool::link(_Pool* nextPool) {
+    next = nextPool; }
 
 _Page* _Pool::allocatePage() {
-    size_t chunksLength = chunks->length();
-    for (int i = 0; i < chunksLength; i++) {
-        _Page* page = (*(*chunks)[i])->allocatePage();
+    for (size_t i = 0; i < chunksLength; i++) {
+        _Page* page = chunks[i]->allocatePage();
         if (page)
             return page; }
 
-    _Chunk* chunk = _Chunk::create();
+    if (chunksLength == chunksCapacity) {
+        size_t capacity = chunksCapacity ? chunksCapacity * 2 : 8;
+        _Chunk** grown = (_Chunk**)realloc(chunks, capacity * sizeof(_Chunk*));
+        if (!grown)
+            return 0;
+        chunks = grown;
+        chunksCapacity = capacity; }
+
+    _Chunk* chunk = _Chunk::create(node);
     if (!chunk)
         return 0;
-    chunks->push(chunk);
+    chunks[chunksLength++] = chunk;
     return chunk->allocatePage(); }
 
 bool _Pool::deallocatePage(_Page* page) {
@@ -27,14 +69,20 @@ bool _Pool::deallocatePage(_Page* page) {
         return false;
     if (chunk->isEmpty()) {
         chunk->dispose();
-        chunks->remove(chunk);
+        removeChunk(chunk);
     }
     return true; }
 
+void _Pool::removeChunk(_Chunk* chunk) {
+    for (size_t i = 0; i < chunksLength; i++) {
+        if (chunks[i] == chunk) {
+            chunksLength--;
+            memmove(chunks + i, chunks + i + 1, (chunksLength - i) * sizeof(_Chunk*));
+            return; } } }
+
 _Chunk* _Pool::getContainingChunk(_Page* page) {
-    size_t chunksLength = chunks->length();
-    for (int i = 0; i < chunksLength; i++) {
-        _Chunk* chunk = *(*chunks)[i];
+    for (size_t i = 0; i < chunksLength; i++) {
+        _Chunk* chunk = chunks[i];
         _Page* basePage = chunk->_getPage();
         _Page* upperBound = (_Page*)((char*)basePage + _pageSize * _Chunk::numberOfPages);
         if ((page > basePage) && (page < upperBound))
@@ -44,8 +92,11 @@ _Chunk* _Pool::getContainingChunk(_Page* page) {
 }
 
 void _Pool::dispose() {
-    size_t chunksLength = chunks->length();
-    for (int i = 0; i < chunksLength; i++)
-        (*(*chunks)[i])->dispose(); }
+    for (size_t i = 0; i < chunksLength; i++)
+        chunks[i]->dispose();
+    free(chunks);
+    chunks = 0;
+    chunksLength = 0;
+    chunksCapacity = 0; }
 }
 
@@ -3,16 +3,36 @@
 #include "Scaly.h"
 namespace scaly {
 
-class _Pool : public Object {
+// The pool is shared by all tasks of a process, so it gets cache lines of its own.
+// With a topology there is a pool per NUMA node whose chunks are bound to it.
+// The pools are linked in a ring, so that a page goes back to the pool it came
+// from whichever task releases it.
+class alignas(_cacheLineSize) _Pool : public Object {
 public:
-    _Pool();
-    _Page* allocatePage();
-    bool deallocatePage(_Page* page);
+    _Pool(int node = -1);
+    void* operator new(size_t size, _Page* page);
+    size_t allocatePages(_Page** pages, size_t count);
+    void deallocatePages(_Page** pages, size_t count);
+    void link(_Pool* nextPool);
     void dispose();
 
 private:
+    void deallocatePages(_Page** pages, size_t count, _Pool* origin);
+    _Page* allocatePage();
+    bool deallocatePage(_Page* page);
     _Chunk* getContainingChunk(_Page* page);
-    _Array<_Chunk>* chunks;
+    void removeChunk(_Chunk* chunk);
+
+    // The list of chunks is malloc'd, since a page allocated while the mutex
+    // is held could come from this pool again. It is only touched under the mutex.
+    _Chunk** chunks;
+    size_t chunksLength;
+    size_t chunksCapacity;
+    pthread_mutex_t mutex;
+
+    // The node the chunks are bound to, or -1
+    int node;
+    _Pool* next;
 };
 
 }
@@ -3,22 +3,28 @@
 #include "Scaly.h"
 namespace scaly {
 
+// Either the result of an operation or the error it failed with. The error is
+// kept by value, payload included, so that failing allocates nothing.
 template<class R, class E> class _Result : public Object {
 public:
     // The operation succeeded
     _Result(R* result)
-    : errorCode(0), payload(result) {}
+    : errorCode(0), result(result) {}
         
     // The operation failed
+    _Result(E error)
+    : errorCode(error._getErrorCode()), error(error) {}
+
+    // The operation failed with an error raised elsewhere
     _Result(E* error)
-    : errorCode((long)(error->_getErrorCode())), payload(error->_getErrorInfo()) {}
+    : errorCode(error->_getErrorCode()), error(*error) {}
     
     bool succeeded() {
         return errorCode == 0;
     }
     
     R* getResult() {
-        return (R*)payload;
+        return result;
     }
     
     long _getErrorCode() {
@@ -26,12 +32,15 @@ public:
     }
     
     E* getError() {
-        return (E*)this;
+        return &error;
     }
 
 private:
     long errorCode;
-    void* payload;
+    union {
+        R* result;
+        E error;
+    };
 };
 
 }
@@ -0,0 +1,162 @@
+#ifndef __Scaly__RingBuffer__
+#define __Scaly__RingBuffer__
+#include "Scaly.h"
+namespace scaly {
+
+// A bounded queue of pointers between exactly one producing and one consuming thread.
+// The slots live on an exclusive page of the queue. The producer's and the consumer's
+// positions are on cache lines of their own, each next to the side's cached copy of
+// the other position, so that a side only reads the other's line when its copy says
+// the queue is full or empty. Items must not be 0.
+template<class T> class alignas(_cacheLineSize) _RingBuffer : public Object {
+public:
+    // A queue of at least capacity slots, rounded up to a power of two
+    _RingBuffer<T>(size_t capacity)
+    : mask(roundUp(capacity) - 1), head(0), cachedTail(0), tail(0), cachedHead(0) {
+        slots = (T**)_getPage()->allocateExclusivePage()->allocateObject((mask + 1) * sizeof(T*));
+    }
+
+    void* operator new(size_t size, _Page* page) {
+        return alignToCacheLine((char*)Object::operator new(size + _cacheLineSize - _alignment, page));
+    }
+
+    size_t getCapacity() {
+        return mask + 1;
+    }
+
+    // Called by the producer only. Returns false if the queue is full.
+    bool push(T* item) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (position - cachedHead > mask)
+                return false;
+        }
+
+        slots[position & mask] = item;
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Called by the consumer only. Returns 0 if the queue is empty.
+    T* pop() {
+        size_t position = head.load(std::memory_order_relaxed);
+        if (position == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (position == cachedTail)
+                return 0;
+        }
+
+        T* item = slots[position & mask];
+        head.store(position + 1, std::memory_order_release);
+        return item;
+    }
+
+    static size_t roundUp(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        return size;
+    }
+
+private:
+    T** slots;
+    size_t mask;
+
+    // Written by the consumer
+    alignas(_cacheLineSize) std::atomic<size_t> head;
+    size_t cachedTail;
+
+    // Written by the producer
+    alignas(_cacheLineSize) std::atomic<size_t> tail;
+    size_t cachedHead;
+};
+
+// A bounded queue of pointers between any number of producing and consuming threads.
+// Each slot carries a sequence number telling whether it is ready to be written or
+// read in the current round, so producers and consumers only contend for their own
+// position, each of which is on a cache line of its own. Items must not be 0.
+template<class T> class alignas(_cacheLineSize) _ConcurrentRingBuffer : public Object {
+public:
+    // A queue of at least capacity slots, rounded up to a power of two
+    _ConcurrentRingBuffer<T>(size_t capacity)
+    : mask(_RingBuffer<T>::roundUp(capacity) - 1), head(0), tail(0) {
+        slots = (_Slot*)_getPage()->allocateExclusivePage()->allocateObject((mask + 1) * sizeof(_Slot));
+        for (size_t i = 0; i <= mask; i++) {
+            new(&slots[i].sequence) std::atomic<size_t>(i);
+            slots[i].item = 0;
+        }
+    }
+
+    void* operator new(size_t size, _Page* page) {
+        return alignToCacheLine((char*)Object::operator new(size + _cacheLineSize - _alignment, page));
+    }
+
+    size_t getCapacity() {
+        return mask + 1;
+    }
+
+    // Returns false if the queue is full
+    bool push(T* item) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            _Slot* slot = slots + (position & mask);
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+            if (!difference) {
+                // The slot is free in this round, so we try to claim the position
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot->item = item;
+                    slot->sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0) {
+                // The slot still holds the item of the previous round
+                return false;
+            }
+            else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Returns 0 if the queue is empty
+    T* pop() {
+        size_t position = head.load(std::memory_order_relaxed);
+        for (;;) {
+            _Slot* slot = slots + (position & mask);
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+            if (!difference) {
+                if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    T* item = slot->item;
+                    // The slot is free again one round later
+                    slot->sequence.store(position + mask + 1, std::memory_order_release);
+                    return item;
+                }
+            }
+            else if (difference < 0) {
+                return 0;
+            }
+            else {
+                position = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct _Slot {
+        std::atomic<size_t> sequence;
+        T* item;
+    };
+
+    _Slot* slots;
+    size_t mask;
+
+    alignas(_cacheLineSize) std::atomic<size_t> head;
+    alignas(_cacheLineSize) std::atomic<size_t> tail;
+};
+
+}
+#endif//__Scaly__RingBuffer__
@@ -0,0 +1,139 @@
+#include "Scaly.h"
+#include <stddef.h>
+#include <sys/uio.h>
+#include <unistd.h>
+namespace scaly {
+
+// What is left of an exclusive page after its header, the segment header, and
+// the slots at the end of the page which track extensions
+static const size_t segmentCapacity = _pageSize - sizeof(_Page) - 4 * sizeof(_Page*) - 3 * sizeof(size_t);
+
+static const size_t firstSegmentCapacity = 256;
+
+// Written in one go for indentation
+static const char spaces[] = "                                                                ";
+
+// How many segments go into a single writev call
+static const int maxVectors = 64;
+
+_Rope::_Rope()
+: first(0), last(0), length(0) {
+}
+
+void _Rope::addSegment() {
+    size_t capacity = last ? segmentCapacity : firstSegmentCapacity;
+    _Page* page = last ? _getPage()->allocateExclusivePage() : _getPage();
+    _Segment* segment = (_Segment*)page->allocateObject(offsetof(_Segment, data) + capacity);
+    segment->next = 0;
+    segment->length = 0;
+    segment->capacity = capacity;
+    if (last)
+        last->next = segment;
+    else
+        first = segment;
+    last = segment;
+}
+
+void _Rope::append(const char* data, size_t size) {
+    length += size;
+    while (size) {
+        if (!last || last->length == last->capacity)
+            addSegment();
+
+        size_t chunk = last->capacity - last->length;
+        if (chunk > size)
+            chunk = size;
+        memcpy(last->data + last->length, data, chunk);
+        last->length += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+void _Rope::append(char c) {
+    if (!last || last->length == last->capacity)
+        addSegment();
+
+    last->data[last->length++] = c;
+    length++;
+}
+
+void _Rope::append(string* theString) {
+    append(theString->getNativeString(), theString->getLength());
+}
+
+void _Rope::append(VarString* theString) {
+    append(theString->getNativeString(), theString->getLength());
+}
+
+void _Rope::append(_Slice slice) {
+    append(slice.getData(), slice.getLength());
+}
+
+void _Rope::appendDecimal(size_t number) {
+    char digits[20];
+    char* end = digits + sizeof(digits);
+    char* start = _writeDecimal(end, number);
+    append(start, end - start);
+}
+
+void _Rope::appendIndentation(size_t level) {
+    size_t count = level * 4;
+    while (count > sizeof(spaces) - 1) {
+        append(spaces, sizeof(spaces) - 1);
+        count -= sizeof(spaces) - 1;
+    }
+    append(spaces, count);
+}
+
+size_t _Rope::getLength() {
+    return length;
+}
+
+string* _Rope::toString(_Page* _rp) {
+    string* ret = new(_rp) string(length);
+    char* buffer = ret->getNativeString();
+    for (_Segment* segment = first; segment; segment = segment->next) {
+        memcpy(buffer, segment->data, segment->length);
+        buffer += segment->length;
+    }
+
+    return ret;
+}
+
+bool _Rope::writeTo(int fileDescriptor) {
+    _Segment* segment = first;
+    struct iovec vectors[maxVectors];
+    while (segment) {
+        int count = 0;
+        size_t size = 0;
+        for (; segment && count < maxVectors; segment = segment->next, count++) {
+            vectors[count].iov_base = segment->data;
+            vectors[count].iov_len = segment->length;
+            size += segment->length;
+        }
+
+        // Continue after a partial write until the batch is through
+        struct iovec* vector = vectors;
+        while (size) {
+            ssize_t written = writev(fileDescriptor, vector, count);
+            if (written < 0)
+                return false;
+
+            size -= written;
+            while (count && (size_t)written >= vector->iov_len) {
+                written -= vector->iov_len;
+                vector++;
+                count--;
+            }
+            if (count) {
+                vector->iov_base = (char*)vector->iov_base + written;
+                vector->iov_len -= written;
+            }
+        }
+    }
+
+    return true;
+}
+
+}
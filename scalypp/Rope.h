@@ -0,0 +1,56 @@
+#ifndef __Scaly__Rope__
+#define __Scaly__Rope__
+namespace scaly {
+
+// Output which is only appended to and then written as a whole, like a generated
+// source file. The text is kept in a chain of page-sized segments, so growing never
+// moves what has been written, and writeTo passes all segments to a single writev.
+// The first segment is small and sits on the page of the rope, so that short text
+// does not cost a page.
+class _Rope : public Object {
+public:
+    _Rope();
+
+    // Only for literals, since the length is taken from the array type
+    template<size_t N> void append(const char (&literal)[N]) {
+        append(literal, N - 1);
+    }
+
+    void append(const char* data, size_t length);
+    void append(char c);
+    void append(string* theString);
+    void append(VarString* theString);
+    void append(_Slice slice);
+    void appendDecimal(size_t number);
+
+    // Four spaces per level
+    void appendIndentation(size_t level);
+
+    size_t getLength();
+
+    // A contiguous copy of the text on _rp
+    string* toString(_Page* _rp);
+
+    // Returns false if the descriptor could not take all of the text
+    bool writeTo(int fileDescriptor);
+
+private:
+    struct _Segment {
+        _Segment* next;
+        size_t length;
+        size_t capacity;
+        char data[1];
+    };
+
+    void addSegment();
+
+    _Segment* first;
+    _Segment* last;
+    size_t length;
+};
+
+// The rope as seen from Scaly code
+typedef _Rope Rope;
+
+}
+#endif // __Scaly__Rope__
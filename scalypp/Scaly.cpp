@@ -12,4 +12,12 @@ char* align(char* unalignedPointer) {
     return (char*)unalignedPointerAsNumber;
 }
 
+char* alignToCacheLine(char* unalignedPointer) {
+    long long pointerAsNumber = (long long)unalignedPointer;
+    pointerAsNumber += _cacheLineSize - 1;
+    pointerAsNumber &= ~(long long)(_cacheLineSize - 1);
+
+    return (char*)pointerAsNumber;
+}
+
 }
@@ -5,31 +5,55 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <pthread.h>
+#include <atomic>
+#include <type_traits>
 #include <new>
 #include <iostream>
 
 const int _alignment = 8;
 const size_t _pageSize = 0x1000;
 const size_t _maxStackPages = 0x100;
+const size_t _cacheLineSize = 64;
+
+// Declared ahead of the headers since templates align their storage with them
+namespace scaly {
+char* align(char*);
+char* alignToCacheLine(char*);
+}
 
 #include "Page.h"
 #include "Object.h"
 #include "Array.h"
+#include "Vector.h"
+#include "BitSet.h"
+#include "Hash.h"
+#include "HashMap.h"
+#include "BTreeMap.h"
+#include "PersistentVector.h"
+#include "PersistentHashMap.h"
 #include "Chunk.h"
 #include "Pool.h"
+#include "Topology.h"
 #include "Task.h"
 #include "Region.h"
 #include "Result.h"
+#include "Future.h"
+#include "RingBuffer.h"
+#include "Deque.h"
+#include "Sort.h"
 #include "LetString.h"
 #include "VarString.h"
+#include "Utf8.h"
+#include "Slice.h"
+#include "StringBuilder.h"
+#include "Rope.h"
 #include "Number.h"
+#include "Format.h"
+#include "Interner.h"
 #include "Path.h"
 #include "File.h"
 #include "Directory.h"
 #include "Console.h"
 
-namespace scaly {
-char* align(char*);
-
-}
 #endif//__Scaly_Scaly__
@@ -0,0 +1,202 @@
+#ifndef __Scaly__Slice__
+#define __Scaly__Slice__
+namespace scaly {
+
+// The position of the first c in the length bytes at data, or length if there is none.
+// The C library already picks a vectorized memchr for the CPU.
+inline size_t _findChar(const char* data, size_t length, char c) {
+    const char* found = (const char*)memchr(data, c, length);
+    return found ? found - data : length;
+}
+
+// A view of length chars at data, usually into the buffer of a string or VarString.
+// A slice owns nothing, so it must not outlive the buffer it refers to.
+// None of its operations allocate, except toString.
+class _Slice {
+public:
+    static const size_t notFound = (size_t)-1;
+
+    // U+FFFD, which stands for bytes which are not valid UTF-8
+    static const uint32_t replacementCharacter = 0xfffd;
+
+    _Slice()
+    : data(0), length(0) {}
+
+    _Slice(const char* theData, size_t theLength)
+    : data(theData), length(theLength) {}
+
+    _Slice(string* theString)
+    : data(theString->getNativeString()), length(theString->getLength()) {}
+
+    _Slice(VarString* theString)
+    : data(theString->getNativeString()), length(theString->getLength()) {}
+
+    const char* getData() const {
+        return data;
+    }
+
+    size_t getLength() const {
+        return length;
+    }
+
+    bool isEmpty() const {
+        return !length;
+    }
+
+    char operator [](size_t i) const {
+        return data[i];
+    }
+
+    bool equals(_Slice other) const {
+        return length == other.length && !memcmp(data, other.data, length);
+    }
+
+    bool equals(const char* theString) const {
+        size_t theLength = strlen(theString);
+        return theLength == length && !memcmp(data, theString, length);
+    }
+
+    // The position of the first c at or after start, or notFound
+    size_t find(char c, size_t start = 0) const {
+        if (start >= length)
+            return notFound;
+
+        size_t found = start + _findChar(data + start, length - start, c);
+        return found < length ? found : notFound;
+    }
+
+    // The position of the first occurrence of needle, or notFound
+    size_t find(_Slice needle) const {
+        if (!needle.length)
+            return 0;
+
+        for (size_t i = find(needle.data[0]); i != notFound; i = find(needle.data[0], i + 1)) {
+            if (i + needle.length > length)
+                return notFound;
+            if (!memcmp(data + i, needle.data, needle.length))
+                return i;
+        }
+
+        return notFound;
+    }
+
+    // The position of the last c, or notFound
+    size_t findLast(char c) const {
+        for (size_t i = length; i > 0; i--) {
+            if (data[i - 1] == c)
+                return i - 1;
+        }
+
+        return notFound;
+    }
+
+    // The count chars at start, clipped to the end of the slice
+    _Slice sub(size_t start, size_t count = notFound) const {
+        if (start > length)
+            start = length;
+        if (count > length - start)
+            count = length - start;
+
+        return _Slice(data + start, count);
+    }
+
+    bool startsWith(_Slice prefix) const {
+        return prefix.length <= length && !memcmp(data, prefix.data, prefix.length);
+    }
+
+    bool endsWith(_Slice suffix) const {
+        return suffix.length <= length && !memcmp(data + length - suffix.length, suffix.data, suffix.length);
+    }
+
+    _Slice withoutPrefix(_Slice prefix) const {
+        return startsWith(prefix) ? sub(prefix.length) : *this;
+    }
+
+    _Slice withoutSuffix(_Slice suffix) const {
+        return endsWith(suffix) ? sub(0, length - suffix.length) : *this;
+    }
+
+    _Slice trim() const {
+        size_t start = 0;
+        size_t end = length;
+        while (start < end && isWhitespace(data[start]))
+            start++;
+        while (end > start && isWhitespace(data[end - 1]))
+            end--;
+
+        return _Slice(data + start, end - start);
+    }
+
+    // Skip separators, store the chars up to the next separator or the end
+    // in part and drop them from this slice. Returns false if no part is left.
+    bool split(char separator, _Slice* part) {
+        while (length && *data == separator) {
+            data++;
+            length--;
+        }
+        if (!length)
+            return false;
+
+        size_t end = find(separator);
+        if (end == notFound)
+            end = length;
+        *part = _Slice(data, end);
+        data += end;
+        length -= end;
+        return true;
+    }
+
+    bool isValidUtf8() const {
+        return _isValidUtf8(data, length);
+    }
+
+    // The number of code points, which is the length for ASCII
+    size_t getCodePointCount() const {
+        return _countCodePoints(data, length);
+    }
+
+    // Stores the code point at *position in codePoint and moves position past it.
+    // A byte which does not start a well formed code point comes out on its own
+    // as replacementCharacter. Returns false at the end of the slice.
+    bool nextCodePoint(size_t* position, uint32_t* codePoint) const {
+        if (*position >= length)
+            return false;
+
+        size_t bytes = _decodeCodePoint(data + *position, length - *position, codePoint);
+        if (!bytes) {
+            *codePoint = replacementCharacter;
+            bytes = 1;
+        }
+        *position += bytes;
+        return true;
+    }
+
+    // The number of bytes of the code point at position if it may start an identifier, or 0
+    size_t getIdentifierStartLength(size_t position) const {
+        uint32_t codePoint;
+        size_t bytes = position < length ? _decodeCodePoint(data + position, length - position, &codePoint) : 0;
+        return bytes && _isIdentifierStart(codePoint) ? bytes : 0;
+    }
+
+    // The number of bytes of the code point at position if it may go on with an identifier, or 0
+    size_t getIdentifierPartLength(size_t position) const {
+        uint32_t codePoint;
+        size_t bytes = position < length ? _decodeCodePoint(data + position, length - position, &codePoint) : 0;
+        return bytes && _isIdentifierPart(codePoint) ? bytes : 0;
+    }
+
+    string* toString(_Page* _rp) const {
+        return new(_rp) string(data, length);
+    }
+
+private:
+    static bool isWhitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    const char* data;
+    size_t length;
+};
+
+}
+#endif // __Scaly__Slice__
@@ -0,0 +1,60 @@
+#include "Scaly.h"
+namespace scaly {
+
+extern __thread _Task* __CurrentTask;
+
+struct _SortWorker {
+    void (*work)(void* argument, size_t part);
+    void* argument;
+    size_t part;
+    _Task* task;
+    pthread_t thread;
+    bool spawned;
+    bool done;
+};
+
+static void* runWorker(void* sortWorker) {
+    _SortWorker* worker = (_SortWorker*)sortWorker;
+    _Page* rootPage = _Task::enterThread(worker->task);
+    if (!rootPage)
+        return 0;
+    worker->work(worker->argument, worker->part);
+    worker->done = true;
+    _Task::leaveThread(rootPage);
+    return 0;
+}
+
+void Sort::runParts(size_t parts, void (*work)(void* argument, size_t part), void* argument) {
+    _Region _region; _Page* _p = _region.get();
+    _SortWorker* workers = (_SortWorker*)_p->allocateObject(parts * sizeof(_SortWorker));
+    for (size_t i = 1; i < parts; i++) {
+        _SortWorker* worker = workers + i;
+        worker->work = work;
+        worker->argument = argument;
+        worker->part = i;
+        worker->task = __CurrentTask;
+        worker->done = false;
+        worker->spawned = pthread_create(&worker->thread, 0, runWorker, worker) == 0;
+    }
+
+    work(argument, 0);
+
+    // A part which no worker could do is done by the calling thread
+    for (size_t i = 1; i < parts; i++) {
+        _SortWorker* worker = workers + i;
+        if (worker->spawned)
+            pthread_join(worker->thread, 0);
+        if (!worker->done)
+            work(argument, i);
+    }
+}
+
+size_t Sort::getParts(size_t length) {
+    size_t workers = __CurrentTask->getNumberOfWorkers();
+    size_t parts = 1;
+    while (parts * 2 <= workers && length / (parts * 2) >= minimumPart)
+        parts *= 2;
+    return parts;
+}
+
+}
@@ -0,0 +1,327 @@
+#ifndef __Scaly__Sort__
+#define __Scaly__Sort__
+namespace scaly {
+
+// Stable sorting of _Arrays, _Vectors and plain spans of items.
+// mergeSort orders by lessThan(a, b). radixSort orders by the unsigned integer
+// key(item), a byte per pass, and radixSortByString by the bytes of key(item),
+// which has to provide getNativeString and getLength like string and VarString
+// do, with the shorter string first on a tie. The scratch space comes from a
+// temporary region. Large inputs are cut into parts which are sorted on worker
+// threads and then merged, also on worker threads, so lessThan and key have to
+// be safe to call from several threads at once.
+class Sort {
+public:
+    template<class T, class C> static void mergeSort(_Array<T>* array, C lessThan) {
+        mergeSort(array->getRawArray(), array->length(), lessThan);
+    }
+
+    template<class T, class C> static void mergeSort(_Vector<T>* vector, C lessThan) {
+        mergeSort(vector->getRawArray(), vector->length(), lessThan);
+    }
+
+    template<class E, class C> static void mergeSort(E* items, size_t length, C lessThan) {
+        sortInParallel(items, length, _MergePart<E, C>(lessThan), lessThan);
+    }
+
+    template<class T, class K> static void radixSort(_Array<T>* array, K key) {
+        radixSort(array->getRawArray(), array->length(), key);
+    }
+
+    template<class T, class K> static void radixSort(_Vector<T>* vector, K key) {
+        radixSort(vector->getRawArray(), vector->length(), key);
+    }
+
+    template<class E, class K> static void radixSort(E* items, size_t length, K key) {
+        sortInParallel(items, length, _RadixPart<E, K>(key), _KeyLessThan<E, K>(key));
+    }
+
+    template<class T, class S> static void radixSortByString(_Array<T>* array, S key) {
+        radixSortByString(array->getRawArray(), array->length(), key);
+    }
+
+    template<class T, class S> static void radixSortByString(_Vector<T>* vector, S key) {
+        radixSortByString(vector->getRawArray(), vector->length(), key);
+    }
+
+    template<class E, class S> static void radixSortByString(E* items, size_t length, S key) {
+        sortInParallel(items, length, _StringPart<E, S>(key), _StringLessThan<E, S>(key));
+    }
+
+    // Inputs shorter than this are sorted on the calling thread alone
+    static const size_t minimumPart = 1 << 15;
+
+private:
+    // Calls work(argument, part) for each of parts parts. Part 0 runs on the
+    // calling thread, the others on worker threads with tasks of their own.
+    static void runParts(size_t parts, void (*work)(void* argument, size_t part), void* argument);
+
+    // The number of parts for length items, a power of two which is 1 for small inputs
+    static size_t getParts(size_t length);
+
+    // Runs of this length are put in order by insertion before they are merged
+    static const size_t insertionRun = 32;
+
+    template<class E, class C> static void insertionSort(E* items, size_t length, C& lessThan) {
+        for (size_t i = 1; i < length; i++) {
+            E item = items[i];
+            size_t j = i;
+            for (; j > 0 && lessThan(item, items[j - 1]); j--)
+                items[j] = items[j - 1];
+            items[j] = item;
+        }
+    }
+
+    // Merges the adjacent sorted runs into target, taking from the left one on a tie
+    template<class E, class C> static void mergeRuns(E* left, size_t leftLength, size_t rightLength, E* target, C& lessThan) {
+        E* right = left + leftLength;
+        E* leftEnd = right;
+        E* rightEnd = right + rightLength;
+
+        // Runs which are already in order are only copied
+        if (!leftLength || !rightLength || !lessThan(*right, *(leftEnd - 1))) {
+            memcpy(target, left, (leftLength + rightLength) * sizeof(E));
+            return;
+        }
+
+        while (left < leftEnd && right < rightEnd)
+            *target++ = lessThan(*right, *left) ? *right++ : *left++;
+        memcpy(target, left, (leftEnd - left) * sizeof(E));
+        target += leftEnd - left;
+        memcpy(target, right, (rightEnd - right) * sizeof(E));
+    }
+
+    template<class E, class C> static void mergeSortWith(E* items, E* scratch, size_t length, C& lessThan) {
+        for (size_t i = 0; i < length; i += insertionRun)
+            insertionSort(items + i, length - i < insertionRun ? length - i : insertionRun, lessThan);
+
+        E* source = items;
+        E* target = scratch;
+        for (size_t width = insertionRun; width < length; width *= 2) {
+            for (size_t i = 0; i < length; i += 2 * width) {
+                size_t middle = i + width < length ? i + width : length;
+                size_t end = middle + width < length ? middle + width : length;
+                mergeRuns(source + i, middle - i, end - middle, target + i, lessThan);
+            }
+            E* sorted = target;
+            target = source;
+            source = sorted;
+        }
+
+        if (source != items)
+            memcpy(items, source, length * sizeof(E));
+    }
+
+    template<class E, class K> static void radixSortWith(E* items, E* scratch, size_t length, K& key) {
+        typedef typename std::decay<decltype(key(*items))>::type Key;
+        static_assert(std::is_unsigned<Key>::value, "radixSort needs an unsigned integer key");
+        if (length < 2)
+            return;
+
+        // The counts of all digits are taken in a single pass
+        size_t counts[sizeof(Key)][256];
+        memset(counts, 0, sizeof counts);
+        for (size_t i = 0; i < length; i++) {
+            Key k = key(items[i]);
+            for (size_t digit = 0; digit < sizeof(Key); digit++)
+                counts[digit][(size_t)(k >> (8 * digit)) & 0xff]++;
+        }
+
+        E* source = items;
+        E* target = scratch;
+        for (size_t digit = 0; digit < sizeof(Key); digit++) {
+            size_t* offsets = counts[digit];
+
+            // A digit which all items share does not change the order
+            if (offsets[(size_t)(key(*source) >> (8 * digit)) & 0xff] == length)
+                continue;
+
+            size_t offset = 0;
+            for (size_t i = 0; i < 256; i++) {
+                size_t count = offsets[i];
+                offsets[i] = offset;
+                offset += count;
+            }
+
+            for (size_t i = 0; i < length; i++)
+                target[offsets[(size_t)(key(source[i]) >> (8 * digit)) & 0xff]++] = source[i];
+
+            E* sorted = target;
+            target = source;
+            source = sorted;
+        }
+
+        if (source != items)
+            memcpy(items, source, length * sizeof(E));
+    }
+
+    // Eight bytes of a string from offset on, padded with zeros, as a number which sorts like them
+    static uint64_t prefixOf(const char* data, size_t length, size_t offset) {
+        uint64_t prefix = 0;
+        if (length <= offset)
+            return prefix;
+
+        size_t bytes = length - offset < sizeof(uint64_t) ? length - offset : sizeof(uint64_t);
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        memcpy(&prefix, data + offset, bytes);
+        return __builtin_bswap64(prefix);
+#else
+        for (size_t i = 0; i < bytes; i++)
+            prefix |= (uint64_t)(unsigned char)data[offset + i] << (56 - 8 * i);
+        return prefix;
+#endif
+    }
+
+    template<class E> struct _Prefixed {
+        uint64_t prefix;
+        E item;
+    };
+
+    struct _PrefixKey {
+        template<class E> uint64_t operator()(const _Prefixed<E>& prefixed) {
+            return prefixed.prefix;
+        }
+    };
+
+    // Radix sorts the strings by eight bytes from offset on, then goes on with
+    // the next eight bytes for each run of items which are still tied
+    template<class E, class S> static void radixSortByStringAt(E* items, E* scratch, _Prefixed<E>* prefixed, _Prefixed<E>* prefixedScratch, size_t length, size_t offset, S& key) {
+        for (size_t i = 0; i < length; i++) {
+            prefixed[i].prefix = prefixOf(key(items[i])->getNativeString(), key(items[i])->getLength(), offset);
+            prefixed[i].item = items[i];
+        }
+
+        _PrefixKey prefixKey;
+        radixSortWith(prefixed, prefixedScratch, length, prefixKey);
+        for (size_t i = 0; i < length; i++)
+            items[i] = prefixed[i].item;
+
+        _StringLessThan<E, S> lessThan(key);
+        for (size_t i = 0; i < length;) {
+            size_t j = i + 1;
+            bool longer = key(items[i])->getLength() > offset + sizeof(uint64_t);
+            for (; j < length && prefixed[j].prefix == prefixed[i].prefix; j++)
+                longer = longer || key(items[j])->getLength() > offset + sizeof(uint64_t);
+
+            // Short runs, and those which only differ in trailing zeros, are merged instead
+            if (j - i > insertionRun && longer)
+                radixSortByStringAt(items + i, scratch + i, prefixed + i, prefixedScratch + i, j - i, offset + sizeof(uint64_t), key);
+            else if (j - i > 1)
+                mergeSortWith(items + i, scratch + i, j - i, lessThan);
+            i = j;
+        }
+    }
+
+    template<class E, class S> static void radixSortByStringWith(E* items, E* scratch, size_t length, S& key) {
+        _Region _region; _Page* _p = _region.get();
+        _Prefixed<E>* prefixed = (_Prefixed<E>*)_p->allocateObject(length * sizeof(_Prefixed<E>));
+        _Prefixed<E>* prefixedScratch = (_Prefixed<E>*)_p->allocateObject(length * sizeof(_Prefixed<E>));
+        radixSortByStringAt(items, scratch, prefixed, prefixedScratch, length, 0, key);
+    }
+
+    // How a part is sorted and how two items compare when the parts are merged
+
+    template<class E, class C> struct _MergePart {
+        _MergePart(C& lessThan) : lessThan(lessThan) {}
+        void operator()(E* items, E* scratch, size_t length) {
+            mergeSortWith(items, scratch, length, lessThan);
+        }
+        C lessThan;
+    };
+
+    template<class E, class K> struct _RadixPart {
+        _RadixPart(K& key) : key(key) {}
+        void operator()(E* items, E* scratch, size_t length) {
+            radixSortWith(items, scratch, length, key);
+        }
+        K key;
+    };
+
+    template<class E, class K> struct _KeyLessThan {
+        _KeyLessThan(K& key) : key(key) {}
+        bool operator()(const E& left, const E& right) {
+            return key(left) < key(right);
+        }
+        K key;
+    };
+
+    template<class E, class S> struct _StringPart {
+        _StringPart(S& key) : key(key) {}
+        void operator()(E* items, E* scratch, size_t length) {
+            radixSortByStringWith(items, scratch, length, key);
+        }
+        S key;
+    };
+
+    template<class E, class S> struct _StringLessThan {
+        _StringLessThan(S& key) : key(key) {}
+        bool operator()(const E& left, const E& right) {
+            size_t leftLength = key(left)->getLength();
+            size_t rightLength = key(right)->getLength();
+            int comparison = memcmp(key(left)->getNativeString(), key(right)->getNativeString(), leftLength < rightLength ? leftLength : rightLength);
+            return comparison ? comparison < 0 : leftLength < rightLength;
+        }
+        S key;
+    };
+
+    template<class E, class P, class C> struct _Job {
+        E* items;
+        E* scratch;
+        size_t length;
+        size_t parts;
+        P& sortPart;
+        C& lessThan;
+
+        // Of the current merge round
+        E* source;
+        E* target;
+        size_t width;
+
+        size_t bound(size_t part) {
+            return length / parts * part + (part < length % parts ? part : length % parts);
+        }
+
+        static void sort(void* job, size_t part) {
+            _Job* self = (_Job*)job;
+            size_t first = self->bound(part);
+            self->sortPart(self->items + first, self->scratch + first, self->bound(part + 1) - first);
+        }
+
+        // Merges the parts from 2 * pair * width on with the width parts after them
+        static void merge(void* job, size_t pair) {
+            _Job* self = (_Job*)job;
+            size_t first = self->bound(2 * pair * self->width);
+            size_t middle = self->bound((2 * pair + 1) * self->width);
+            size_t end = self->bound((2 * pair + 2) * self->width);
+            mergeRuns(self->source + first, middle - first, end - middle, self->target + first, self->lessThan);
+        }
+    };
+
+    template<class E, class P, class C> static void sortInParallel(E* items, size_t length, P sortPart, C lessThan) {
+        if (length < 2)
+            return;
+
+        _Region _region; _Page* _p = _region.get();
+        E* scratch = (E*)_p->allocateObject(length * sizeof(E));
+        size_t parts = getParts(length);
+        if (parts == 1) {
+            sortPart(items, scratch, length);
+            return;
+        }
+
+        _Job<E, P, C> job = { items, scratch, length, parts, sortPart, lessThan, items, scratch, 1 };
+        runParts(parts, _Job<E, P, C>::sort, &job);
+        for (; job.width < parts; job.width *= 2) {
+            runParts(parts / (2 * job.width), _Job<E, P, C>::merge, &job);
+            E* sorted = job.target;
+            job.target = job.source;
+            job.source = sorted;
+        }
+
+        if (job.source != items)
+            memcpy(items, job.source, length * sizeof(E));
+    }
+};
+
+}
+#endif // __Scaly__Sort__
@@ -0,0 +1,170 @@
+#include "Scaly.h"
+namespace scaly {
+
+static const char digitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+char* _writeDecimal(char* end, size_t number) {
+    // Two digits per division
+    while (number >= 100) {
+        size_t pair = (number % 100) * 2;
+        number /= 100;
+        *--end = digitPairs[pair + 1];
+        *--end = digitPairs[pair];
+    }
+    if (number >= 10) {
+        *--end = digitPairs[number * 2 + 1];
+        *--end = digitPairs[number * 2];
+    }
+    else {
+        *--end = '0' + number;
+    }
+
+    return end;
+}
+
+_StringBuilder::_StringBuilder()
+: buffer(0), length(0), capacity(0) {
+}
+
+_StringBuilder::_StringBuilder(size_t capacity)
+: buffer(0), length(0), capacity(0) {
+    reserve(capacity);
+}
+
+void _StringBuilder::append(const char* data, size_t size) {
+    if (length + size > capacity)
+        grow(size);
+
+    memcpy(buffer + length, data, size);
+    length += size;
+}
+
+void _StringBuilder::append(char c) {
+    if (length == capacity)
+        grow(1);
+
+    buffer[length++] = c;
+}
+
+void _StringBuilder::append(string* theString) {
+    append(theString->getNativeString(), theString->getLength());
+}
+
+void _StringBuilder::append(VarString* theString) {
+    append(theString->getNativeString(), theString->getLength());
+}
+
+void _StringBuilder::append(_Slice slice) {
+    append(slice.getData(), slice.getLength());
+}
+
+void _StringBuilder::appendDecimal(size_t number) {
+    length = Number::writeDecimal(getNumberBuffer(), number) - buffer;
+}
+
+void _StringBuilder::appendSigned(long long number) {
+    length = Number::writeSigned(getNumberBuffer(), number) - buffer;
+}
+
+void _StringBuilder::appendHex(size_t number) {
+    length = Number::writeHex(getNumberBuffer(), number) - buffer;
+}
+
+void _StringBuilder::appendFloat(double number) {
+    length = Number::writeFloat(getNumberBuffer(), number) - buffer;
+}
+
+void _StringBuilder::reserve(size_t newCapacity) {
+    if (newCapacity > capacity)
+        grow(newCapacity - length);
+}
+
+size_t _StringBuilder::getLength() {
+    return length;
+}
+
+char* _StringBuilder::getNativeString() {
+    if (!buffer)
+        return (char*)"";
+
+    buffer[length] = 0;
+    return buffer;
+}
+
+void _StringBuilder::grow(size_t size) {
+    // The buffer ends after the capacity and the trailing 0
+    if (buffer && _Page::getPage(buffer)->extend(buffer + capacity + 1, length + size - capacity)) {
+        capacity = length + size;
+        return;
+    }
+
+    char* oldBuffer = buffer;
+    size_t newCapacity = capacity * 2;
+    if (newCapacity < length + size)
+        newCapacity = length + size;
+    buffer = (char*)_getPage()->allocateObject(newCapacity + 1);
+    capacity = newCapacity;
+    if (!oldBuffer)
+        return;
+
+    memcpy(buffer, oldBuffer, length);
+
+    // Reclaim the page if it was oversized, i.e., exclusively allocated
+    if (_Page::getPage(oldBuffer)->isOversized())
+        _getPage()->reclaimArray(oldBuffer);
+}
+
+char* _StringBuilder::getNumberBuffer() {
+    if (length + Number::maxLength > capacity)
+        grow(Number::maxLength);
+
+    return buffer + length;
+}
+
+string* _StringBuilder::finish(_Page* _rp) {
+    string* ret;
+    if (length <= string::inlineCapacity) {
+        // Short results are stored within the string anyway
+        ret = new(_rp) string(buffer ? buffer : "", length);
+    }
+    else {
+        ret = new(_rp) string();
+        buffer[length] = 0;
+        ret->length = length;
+        ret->buffer.chars = buffer;
+        ret->buffer.hash.store(0, std::memory_order_relaxed);
+        _Page* bufferPage = _Page::getPage(buffer);
+        if (bufferPage->isOversized()) {
+            // The buffer has a page of its own, which the result page takes over
+            if (!_getPage()->handOverExclusivePage(bufferPage, _rp))
+                ret->buffer.chars = 0;
+        }
+        else {
+            // Unless the buffer happens to share the page with the result, it has to be copied
+            if (_Page::getPage(ret) != bufferPage)
+                ret->buffer.chars = 0;
+        }
+
+        if (!ret->buffer.chars) {
+            ret->buffer.chars = (char*)_rp->allocateObject(length + 1);
+            memcpy(ret->buffer.chars, buffer, length + 1);
+        }
+    }
+
+    buffer = 0;
+    length = 0;
+    capacity = 0;
+    return ret;
+}
+
+}
@@ -0,0 +1,55 @@
+#ifndef __Scaly__StringBuilder__
+#define __Scaly__StringBuilder__
+namespace scaly {
+
+// Writes the decimal digits of number backwards, ending right before end.
+// Returns the first digit. end has to be preceded by room for 20 digits.
+char* _writeDecimal(char* end, size_t number);
+
+// Collects text for a string which is built once and then read, like a generated
+// source file. Appending a literal costs no strlen, and numbers are formatted
+// right into the buffer. When the buffer has outgrown a page, it lives on an
+// oversized page of its own which finish hands over to the result page.
+class _StringBuilder : public Object {
+public:
+    _StringBuilder();
+    _StringBuilder(size_t capacity);
+
+    // Only for literals, since the length is taken from the array type
+    template<size_t N> void append(const char (&literal)[N]) {
+        append(literal, N - 1);
+    }
+
+    void append(const char* data, size_t length);
+    void append(char c);
+    void append(string* theString);
+    void append(VarString* theString);
+    void append(_Slice slice);
+    void appendDecimal(size_t number);
+    void appendSigned(long long number);
+    void appendHex(size_t number);
+    void appendFloat(double number);
+
+    // Make room for capacity chars in total
+    void reserve(size_t capacity);
+    size_t getLength();
+    char* getNativeString();
+
+    // The built string on _rp. The builder is empty afterwards.
+    string* finish(_Page* _rp);
+
+private:
+    void grow(size_t size);
+    // Room for a number at the end of the text
+    char* getNumberBuffer();
+
+    char* buffer;
+    size_t length;
+    size_t capacity;
+};
+
+// The builder as seen from Scaly code
+typedef _StringBuilder StringBuilder;
+
+}
+#endif // __Scaly__StringBuilder__
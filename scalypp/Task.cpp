@@ -1,23 +1,118 @@
 #include "Scaly.h"
+#include <unistd.h>
+#include <assert.h>
 namespace scaly{
 
+extern __thread _Page* __CurrentPage;
 __thread _Task* __CurrentTask = 0;
 
-_Task::_Task() {
-pool = new(_getPage()) _Pool(); }
+_Task::_Task()
+: worker(noWorker), pagesAllocated(0), pagesReleased(0), poolAccesses(0), futuresPending(0), magazineCount(0) {
+    pool = new(_getPage()) _Pool();
+    topology = _Topology::create(_getPage(), pool); }
+
+_Task::_Task(_Task* parentTask, size_t worker)
+: pool(parentTask->pool), topology(parentTask->topology), worker(worker), pagesAllocated(0), pagesReleased(0), poolAccesses(0), futuresPending(0), magazineCount(0) {
+    // A pinned worker takes its pages from its node
+    if (worker != noWorker)
+        pool = topology->getPool(worker);
+}
+
+void* _Task::operator new(size_t size, _Page* page) {
+    return alignToCacheLine((char*)Object::operator new(size + _cacheLineSize - _alignment, page)); }
 
 _Page* _Task::getExtensionPage() {
-    _Page* page = pool->allocatePage();
-    if (!page)
-        return 0;
-    return page; }
+    if (!magazineCount) {
+        // Refill half of the magazine from the pool
+        poolAccesses++;
+        magazineCount = pool->allocatePages(magazine, magazineSize / 2);
+        if (!magazineCount)
+            return 0;
+    }
+
+    pagesAllocated++;
+    magazineCount--;
+    return magazine[magazineCount]; }
 
 void _Task::releaseExtensionPage(_Page* page) {
-    if (!pool->deallocatePage(page))
+    if (page->isOversized()) {
         // This is an oversized page which has to be free'd directly
-        free(page); }
+        free(page);
+        return;
+    }
+
+    // Give back the older half of the magazine if it is full
+    if (magazineCount == magazineSize)
+        flushMagazine(magazineSize / 2);
+
+    pagesReleased++;
+    magazine[magazineCount] = page;
+    magazineCount++; }
+
+void _Task::flushMagazine(size_t count) {
+    poolAccesses++;
+    pool->deallocatePages(magazine, count);
+    magazineCount -= count;
+    memmove(magazine, magazine + count, magazineCount * sizeof(_Page*)); }
+
+size_t _Task::getPagesAllocated() {
+    return pagesAllocated; }
+
+size_t _Task::getPagesReleased() {
+    return pagesReleased; }
+
+size_t _Task::getPoolAccesses() {
+    return poolAccesses; }
+
+size_t _Task::getNumberOfWorkers() {
+    // Without a placement, every CPU which is online may run a worker
+    if (topology)
+        return topology->getNumberOfWorkers();
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? cpus : 1; }
+
+bool _Task::launchFuture() {
+    return futuresPending.fetch_add(1, std::memory_order_relaxed) < getNumberOfWorkers(); }
+
+void _Task::collectFuture() {
+    futuresPending.fetch_sub(1, std::memory_order_relaxed); }
 
 void _Task::dispose() {
-    pool->dispose(); }
+    assert(!futuresPending.load(std::memory_order_relaxed));
+    flushMagazine(magazineCount);
+    pool->dispose();
+    if (topology)
+        topology->dispose(); }
+
+_Page* _Task::enterThread(_Task* parentTask) {
+    // Pin first so that the pages we touch are placed on our node
+    size_t worker = noWorker;
+    if (parentTask->topology)
+        worker = parentTask->topology->pinWorker();
+
+    // Allocate the root page for the worker thread
+    _Page* rootPage = 0;
+    posix_memalign((void**)&rootPage, _pageSize, _pageSize * _maxStackPages);
+    if (!rootPage) {
+        if (worker != noWorker)
+            parentTask->topology->releaseWorker(worker);
+        return 0;
+    }
+    rootPage->reset();
+    __CurrentPage = rootPage;
+    __CurrentTask = new(rootPage) _Task(parentTask, worker);
+    return rootPage; }
+
+void _Task::leaveThread(_Page* rootPage) {
+    assert(!__CurrentTask->futuresPending.load(std::memory_order_relaxed));
+    rootPage->deallocateExtensions();
+    __CurrentTask->flushMagazine(__CurrentTask->magazineCount);
+
+    // Our CPU can take the next worker
+    if (__CurrentTask->worker != noWorker)
+        __CurrentTask->topology->releaseWorker(__CurrentTask->worker);
+    __CurrentPage = 0;
+    __CurrentTask = 0;
+    free(rootPage); }
 
-}
\ No newline at end of file
+}
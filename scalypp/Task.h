@@ -3,18 +3,56 @@
 #include "Scaly.h"
 namespace scaly {
 
-class _Task : public Object {
+// Each thread has a task of its own which lives on cache lines of its own
+class alignas(_cacheLineSize) _Task : public Object {
 public:
     _Task();
+    _Task(_Task* parentTask, size_t worker);
+    void* operator new(size_t size, _Page* page);
     _Page* getExtensionPage();
     _Page* releaseStackPage();
     void releaseExtensionPage(_Page* page);
     void dispose();
+    size_t getPagesAllocated();
+    size_t getPagesReleased();
+    size_t getPoolAccesses();
+    size_t getNumberOfWorkers();
+
+    // Futures of this task which are not collected yet. Returns whether
+    // the new one may have a worker thread of its own.
+    bool launchFuture();
+    void collectFuture();
+    static _Page* enterThread(_Task* parentTask);
+    static void leaveThread(_Page* rootPage);
+
+    // Number of free pages a task caches before it goes to the pool
+    static const size_t magazineSize = 32;
 
 private:
     _Page* allocatePage();
+    void flushMagazine(size_t count);
 
+    // The pool is shared with the tasks of the worker threads
     _Pool* pool;
+
+    // Where worker threads are pinned, if anywhere
+    _Topology* topology;
+
+    // The slot of a pinned worker in the topology
+    size_t worker;
+    static const size_t noWorker = (size_t)-1;
+
+    // Statistics, only ever touched by the owning thread
+    size_t pagesAllocated;
+    size_t pagesReleased;
+    size_t poolAccesses;
+
+    // Counted by _Future, whose get may run on another thread
+    std::atomic<size_t> futuresPending;
+
+    // Free pages of this task
+    size_t magazineCount;
+    _Page* magazine[magazineSize];
 };
 
 }
@@ -0,0 +1,221 @@
+#include "Scaly.h"
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+namespace scaly {
+
+static const char* _cpuDirectory = "/sys/devices/system/cpu";
+
+static int readNumber(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file)
+        return -1;
+    int number = -1;
+    if (fscanf(file, "%d", &number) != 1)
+        number = -1;
+    fclose(file);
+    return number;
+}
+
+static int readCpuNumber(int cpu, const char* entry) {
+    char path[256];
+    snprintf(path, sizeof path, "%s/cpu%d/%s", _cpuDirectory, cpu, entry);
+    return readNumber(path);
+}
+
+static int readNode(int cpu) {
+    // The node of a CPU shows up as a nodeN entry in its directory
+    char path[256];
+    snprintf(path, sizeof path, "%s/cpu%d", _cpuDirectory, cpu);
+    DIR* directory = opendir(path);
+    if (!directory)
+        return 0;
+    int node = 0;
+    struct dirent* entry;
+    while ((entry = readdir(directory)) != 0) {
+        if (sscanf(entry->d_name, "node%d", &node) == 1)
+            break;
+        node = 0;
+    }
+    closedir(directory);
+    return node;
+}
+
+_Topology::_Topology(_Placement placement, _Pool* pool)
+: cpus(0), numberOfCpus(0), pools(0), numberOfNodes(0), workers(0) {
+    readCpus(placement);
+    sortCpus();
+    if (!numberOfCpus)
+        return;
+
+    workers = (std::atomic<size_t>*)_getPage()->allocateObject(numberOfCpus * sizeof(std::atomic<size_t>));
+    for (size_t i = 0; i < numberOfCpus; i++)
+        new(workers + i) std::atomic<size_t>(0);
+    createPools(pool);
+}
+
+void* _Topology::operator new(size_t size, _Page* page) {
+    return alignToCacheLine((char*)Object::operator new(size + _cacheLineSize - _alignment, page));
+}
+
+_Topology* _Topology::create(_Page* _rp, _Pool* pool) {
+    const char* placement = getenv("SCALY_PLACEMENT");
+    if (!placement)
+        return 0;
+
+    _Topology* topology = 0;
+    if (!strcmp(placement, "core"))
+        topology = new(_rp) _Topology(_Placement_physicalCore, pool);
+    if (!strcmp(placement, "thread"))
+        topology = new(_rp) _Topology(_Placement_hardwareThread, pool);
+
+    if (topology && !topology->numberOfCpus)
+        return 0;
+
+    return topology;
+}
+
+void _Topology::readCpus(_Placement placement) {
+    char path[256];
+    snprintf(path, sizeof path, "%s/online", _cpuDirectory);
+    FILE* file = fopen(path, "r");
+    if (!file)
+        return;
+
+    // Read the list of online CPUs like 0-3,8-11
+    int first = 0;
+    int last = 0;
+    int maximum = -1;
+    while (fscanf(file, "%d", &first) == 1) {
+        last = first;
+        int c = fgetc(file);
+        if (c == '-') {
+            if (fscanf(file, "%d", &last) != 1)
+                break;
+            c = fgetc(file);
+        }
+        if (last > maximum) {
+            _Cpu* newCpus = (_Cpu*)_getPage()->allocateObject((last + 1) * sizeof(_Cpu));
+            if (cpus)
+                memcpy(newCpus, cpus, numberOfCpus * sizeof(_Cpu));
+            cpus = newCpus;
+            maximum = last;
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            _Cpu& entry = cpus[numberOfCpus];
+            entry.cpu = cpu;
+            entry.core = readCpuNumber(cpu, "topology/core_id");
+            entry.package = readCpuNumber(cpu, "topology/physical_package_id");
+            entry.cache = readCpuNumber(cpu, "cache/index3/id");
+            if (entry.cache < 0)
+                entry.cache = entry.package;
+            entry.node = readNode(cpu);
+
+            // With one worker per physical core, further SMT threads of a core are skipped
+            bool sibling = false;
+            if (placement == _Placement_physicalCore) {
+                for (size_t i = 0; i < numberOfCpus; i++) {
+                    if (cpus[i].core == entry.core && cpus[i].package == entry.package) {
+                        sibling = true;
+                        break;
+                    }
+                }
+            }
+            if (!sibling)
+                numberOfCpus++;
+        }
+        if (c != ',')
+            break;
+    }
+    fclose(file);
+}
+
+void _Topology::sortCpus() {
+    // Workers which follow each other share nodes and L3 caches as long as possible
+    for (size_t i = 1; i < numberOfCpus; i++) {
+        _Cpu cpu = cpus[i];
+        size_t j = i;
+        while (j > 0) {
+            _Cpu& previous = cpus[j - 1];
+            if (previous.node < cpu.node)
+                break;
+            if (previous.node == cpu.node) {
+                if (previous.cache < cpu.cache)
+                    break;
+                if (previous.cache == cpu.cache) {
+                    if (previous.package < cpu.package)
+                        break;
+                    if (previous.package == cpu.package && previous.core <= cpu.core)
+                        break;
+                }
+            }
+            cpus[j] = previous;
+            j--;
+        }
+        cpus[j] = cpu;
+    }
+}
+
+void _Topology::createPools(_Pool* pool) {
+    for (size_t i = 0; i < numberOfCpus; i++) {
+        if (cpus[i].node >= numberOfNodes)
+            numberOfNodes = cpus[i].node + 1;
+    }
+
+    // The ring starts and ends with the pool of the root task
+    pools = (_Pool**)_getPage()->allocateObject(numberOfNodes * sizeof(_Pool*));
+    _Pool* previous = pool;
+    for (int node = 0; node < numberOfNodes; node++) {
+        pools[node] = new(_getPage()) _Pool(node);
+        previous->link(pools[node]);
+        previous = pools[node];
+    }
+    previous->link(pool);
+}
+
+size_t _Topology::getNumberOfWorkers() {
+    return numberOfCpus;
+}
+
+size_t _Topology::pinWorker() {
+    // The first of the least busy CPUs, so that workers stay close to each other.
+    // Two threads starting at once may pick the same CPU, which only costs balance.
+    size_t worker = 0;
+    for (size_t i = 1; i < numberOfCpus; i++) {
+        if (workers[i].load(std::memory_order_relaxed) < workers[worker].load(std::memory_order_relaxed))
+            worker = i;
+    }
+    workers[worker].fetch_add(1, std::memory_order_relaxed);
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpus[worker].cpu, &cpuSet);
+    pthread_setaffinity_np(pthread_self(), sizeof cpuSet, &cpuSet);
+    return worker;
+}
+
+void _Topology::releaseWorker(size_t worker) {
+    workers[worker].fetch_sub(1, std::memory_order_relaxed);
+}
+
+_Pool* _Topology::getPool(size_t worker) {
+    return pools[cpus[worker].node];
+}
+
+void _Topology::bindToNode(void* address, size_t length, int node) {
+    // mbind without libnuma. The policy only prefers the node, so memory
+    // still comes from elsewhere when the node runs out.
+    const int preferred = 1;
+    unsigned long nodeMask[4] = { 0 };
+    if (node >= (int)(8 * sizeof nodeMask))
+        return;
+    nodeMask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+    syscall(SYS_mbind, address, length, preferred, nodeMask, 8 * sizeof nodeMask + 1, 0);
+}
+
+void _Topology::dispose() {
+    for (int node = 0; node < numberOfNodes; node++)
+        pools[node]->dispose();
+}
+
+}
@@ -0,0 +1,62 @@
+#ifndef __Scaly__Topology__
+#define __Scaly__Topology__
+#include "Scaly.h"
+namespace scaly {
+
+// How worker threads are pinned, configured by the SCALY_PLACEMENT environment variable
+enum _Placement {
+    _Placement_none = 0,
+    _Placement_physicalCore,
+    _Placement_hardwareThread,
+};
+
+// A logical CPU as described in /sys/devices/system/cpu
+struct _Cpu {
+    int cpu;
+    int core;
+    int package;
+    int cache;
+    int node;
+};
+
+// The worker counts are changed by every thread which starts or ends, so they get cache lines of their own
+class alignas(_cacheLineSize) _Topology : public Object {
+public:
+    _Topology(_Placement placement, _Pool* pool);
+    void* operator new(size_t size, _Page* page);
+
+    // The pools of the nodes are linked into a ring with pool
+    static _Topology* create(_Page* _rp, _Pool* pool);
+    size_t getNumberOfWorkers();
+
+    // Pins the calling thread to the CPU with the fewest workers and returns its worker slot
+    size_t pinWorker();
+    void releaseWorker(size_t worker);
+
+    // The pool of the node of the worker slot
+    _Pool* getPool(size_t worker);
+
+    // Asks the kernel to place the pages of the length bytes at address on node
+    static void bindToNode(void* address, size_t length, int node);
+    void dispose();
+
+private:
+    void readCpus(_Placement placement);
+    void sortCpus();
+    void createPools(_Pool* pool);
+
+    // One CPU per worker slot, ordered by node, L3 cache, package and core
+    _Cpu* cpus;
+    size_t numberOfCpus;
+
+    // A pool per node, with chunks bound to that node
+    _Pool** pools;
+    int numberOfNodes;
+
+    // How many threads run on each CPU
+    std::atomic<size_t>* workers;
+};
+
+}
+
+#endif // __Scaly__Topology__
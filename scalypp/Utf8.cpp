@@ -0,0 +1,346 @@
+#include "Scaly.h"
+#if defined(__GNUC__) && defined(__x86_64__)
+#define __Scaly_x86__
+#include <immintrin.h>
+#endif
+namespace scaly {
+
+size_t _decodeCodePoint(const char* data, size_t length, uint32_t* codePoint) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    if (!length)
+        return 0;
+
+    uint32_t c = bytes[0];
+    if (c < 0x80) {
+        *codePoint = c;
+        return 1;
+    }
+
+    size_t count;
+    uint32_t minimum;
+    if (c >= 0xc2 && c <= 0xdf) {
+        count = 2;
+        minimum = 0x80;
+        c &= 0x1f;
+    }
+    else if (c >= 0xe0 && c <= 0xef) {
+        count = 3;
+        minimum = 0x800;
+        c &= 0x0f;
+    }
+    else if (c >= 0xf0 && c <= 0xf4) {
+        count = 4;
+        minimum = 0x10000;
+        c &= 0x07;
+    }
+    else {
+        return 0;
+    }
+
+    if (length < count)
+        return 0;
+    for (size_t i = 1; i < count; i++) {
+        if ((bytes[i] & 0xc0) != 0x80)
+            return 0;
+        c = (c << 6) | (bytes[i] & 0x3f);
+    }
+
+    // Overlong forms and surrogates
+    if (c < minimum || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff))
+        return 0;
+
+    *codePoint = c;
+    return count;
+}
+
+#ifdef __Scaly_x86__
+
+// The number of ASCII bytes at the start of data
+static size_t skipAscii(const char* data, size_t length) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(data + i))))
+            break;
+    }
+    while (i < length && !(data[i] & 0x80))
+        i++;
+    return i;
+}
+
+#else
+
+static size_t skipAscii(const char* data, size_t length) {
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof word);
+        if (word & 0x8080808080808080ULL)
+            break;
+    }
+    while (i < length && !(data[i] & 0x80))
+        i++;
+    return i;
+}
+
+#endif
+
+static bool isValidUtf8Scalar(const char* data, size_t length) {
+    size_t i = 0;
+    while (true) {
+        i += skipAscii(data + i, length - i);
+        if (i == length)
+            return true;
+
+        uint32_t codePoint;
+        size_t bytes = _decodeCodePoint(data + i, length - i, &codePoint);
+        if (!bytes)
+            return false;
+        i += bytes;
+    }
+}
+
+#ifdef __Scaly_x86__
+
+// The errors a byte may take part in, after Keiser and Lemire, "Validating UTF-8
+// in less than one instruction per byte". Three nibble lookups, of the previous
+// byte and of this one, each give the errors their nibble allows; what all three
+// allow is an error. Missing continuations of three and four byte sequences are
+// found by comparing the bytes two and three back.
+static const int8_t tooShort = 1 << 0;
+static const int8_t tooLong = 1 << 1;
+static const int8_t overlong3 = 1 << 2;
+static const int8_t tooLarge = 1 << 3;
+static const int8_t surrogate = 1 << 4;
+static const int8_t overlong2 = 1 << 5;
+static const int8_t tooLarge1000 = 1 << 6;
+static const int8_t overlong4 = 1 << 6;
+static const int8_t twoContinuations = (int8_t)(1 << 7);
+static const int8_t carry = tooShort | tooLong | twoContinuations;
+
+// By the high nibble of the previous byte
+static const int8_t firstHigh[16] = {
+    tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong,
+    twoContinuations, twoContinuations, twoContinuations, twoContinuations,
+    tooShort | overlong2,
+    tooShort,
+    tooShort | overlong3 | surrogate,
+    tooShort | tooLarge | tooLarge1000 | overlong4
+};
+
+// By the low nibble of the previous byte
+static const int8_t firstLow[16] = {
+    carry | overlong3 | overlong2 | overlong4,
+    carry | overlong2,
+    carry,
+    carry,
+    carry | tooLarge,
+    carry | tooLarge | tooLarge1000,
+    carry | tooLarge | tooLarge1000,
+    carry | tooLarge | tooLarge1000,
+    carry | tooLarge | tooLarge1000,
+    carry | tooLarge | tooLarge1000,
+    carry | tooLarge | tooLarge1000,
+    carry | tooLarge | tooLarge1000,
+    carry | tooLarge | tooLarge1000,
+    carry | tooLarge | tooLarge1000 | surrogate,
+    carry | tooLarge | tooLarge1000,
+    carry | tooLarge | tooLarge1000
+};
+
+// By the high nibble of the byte itself
+static const int8_t secondHigh[16] = {
+    tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort,
+    tooLong | overlong2 | twoContinuations | overlong3 | tooLarge1000 | overlong4,
+    tooLong | overlong2 | twoContinuations | overlong3 | tooLarge,
+    tooLong | overlong2 | twoContinuations | surrogate | tooLarge,
+    tooLong | overlong2 | twoContinuations | surrogate | tooLarge,
+    tooShort, tooShort, tooShort, tooShort
+};
+
+// The bytes before input, taking the last ones of previous
+template<int N> __attribute__((target("avx2")))
+static __m256i before(__m256i input, __m256i previous) {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+}
+
+__attribute__((target("avx2")))
+static __m256i lookup(__m256i table, __m256i nibbles) {
+    return _mm256_shuffle_epi8(table, nibbles);
+}
+
+__attribute__((target("avx2")))
+static bool isValidUtf8Avx2(const char* data, size_t length) {
+    __m256i lowNibble = _mm256_set1_epi8(0x0f);
+    __m256i first1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)firstHigh));
+    __m256i first2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)firstLow));
+    __m256i second = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)secondHigh));
+
+    // A lead byte in the last three positions whose sequence does not fit before the end
+    __m256i complete = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)0xef, (char)0xdf, (char)0xbf);
+
+    __m256i error = _mm256_setzero_si256();
+    __m256i previous = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    for (size_t i = 0; i < length; i += 32) {
+        __m256i input;
+        if (i + 32 <= length) {
+            input = _mm256_loadu_si256((const __m256i*)(data + i));
+        }
+        else {
+            // The rest is padded with ASCII, which ends any sequence too early
+            char rest[32];
+            memset(rest, 0, sizeof rest);
+            memcpy(rest, data + i, length - i);
+            input = _mm256_loadu_si256((const __m256i*)rest);
+        }
+
+        if (!_mm256_movemask_epi8(input)) {
+            error = _mm256_or_si256(error, incomplete);
+            incomplete = _mm256_setzero_si256();
+            previous = input;
+            continue;
+        }
+
+        __m256i previous1 = before<1>(input, previous);
+        __m256i special = _mm256_and_si256(
+            _mm256_and_si256(
+                lookup(first1, _mm256_and_si256(_mm256_srli_epi16(previous1, 4), lowNibble)),
+                lookup(first2, _mm256_and_si256(previous1, lowNibble))),
+            lookup(second, _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibble)));
+
+        // Third and fourth bytes of a sequence have their high bit set here
+        __m256i third = _mm256_subs_epu8(before<2>(input, previous), _mm256_set1_epi8(0xe0 - 0x80));
+        __m256i fourth = _mm256_subs_epu8(before<3>(input, previous), _mm256_set1_epi8(0xf0 - 0x80));
+        __m256i continuations = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8((char)0x80));
+        error = _mm256_or_si256(error, _mm256_xor_si256(continuations, special));
+
+        incomplete = _mm256_subs_epu8(input, complete);
+        previous = input;
+    }
+
+    error = _mm256_or_si256(error, incomplete);
+    bool valid = _mm256_testz_si256(error, error);
+    _mm256_zeroupper();
+    return valid;
+}
+
+static size_t countContinuationsSse2(const char* data, size_t length) {
+    // Continuation bytes are those below 0xc0 taken as signed
+    __m128i lead = _mm_set1_epi8((char)0xc0);
+    size_t count = 0;
+    size_t i = 0;
+    while (i + 16 <= length) {
+        __m128i counts = _mm_setzero_si128();
+        for (size_t rounds = 0; rounds < 255 && i + 16 <= length; rounds++, i += 16) {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)(data + i));
+            counts = _mm_sub_epi8(counts, _mm_cmplt_epi8(chunk, lead));
+        }
+        __m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+        count += _mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4);
+    }
+    for (; i < length; i++)
+        count += (data[i] & 0xc0) == 0x80;
+    return count;
+}
+
+__attribute__((target("avx2")))
+static size_t countContinuationsAvx2(const char* data, size_t length) {
+    __m256i lead = _mm256_set1_epi8((char)0xc0);
+    size_t count = 0;
+    size_t i = 0;
+    while (i + 32 <= length) {
+        __m256i counts = _mm256_setzero_si256();
+        for (size_t rounds = 0; rounds < 255 && i + 32 <= length; rounds++, i += 32) {
+            __m256i chunk = _mm256_loadu_si256((const __m256i*)(data + i));
+            counts = _mm256_sub_epi8(counts, _mm256_cmpgt_epi8(lead, chunk));
+        }
+        __m256i sums = _mm256_sad_epu8(counts, _mm256_setzero_si256());
+        count += _mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1)
+            + _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3);
+    }
+    _mm256_zeroupper();
+    return count + countContinuationsSse2(data + i, length - i);
+}
+
+// Detected on first use; the initialization of a local static is thread safe
+static bool hasAvx2() {
+    static const bool avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return avx2;
+}
+
+bool _isValidUtf8(const char* data, size_t length) {
+    return hasAvx2() ? isValidUtf8Avx2(data, length) : isValidUtf8Scalar(data, length);
+}
+
+size_t _countCodePoints(const char* data, size_t length) {
+    return length - (hasAvx2() ? countContinuationsAvx2(data, length) : countContinuationsSse2(data, length));
+}
+
+#else
+
+bool _isValidUtf8(const char* data, size_t length) {
+    return isValidUtf8Scalar(data, length);
+}
+
+size_t _countCodePoints(const char* data, size_t length) {
+    size_t count = 0;
+    for (size_t i = 0; i < length; i++)
+        count += (data[i] & 0xc0) != 0x80;
+    return count;
+}
+
+#endif
+
+// The ranges of C++11 [charname.allowed], sorted
+static const uint32_t allowedRanges[][2] = {
+    { 0xa8, 0xa8 }, { 0xaa, 0xaa }, { 0xad, 0xad }, { 0xaf, 0xaf }, { 0xb2, 0xb5 },
+    { 0xb7, 0xba }, { 0xbc, 0xbe }, { 0xc0, 0xd6 }, { 0xd8, 0xf6 }, { 0xf8, 0xff },
+    { 0x100, 0x167f }, { 0x1681, 0x180d }, { 0x180f, 0x1fff },
+    { 0x200b, 0x200d }, { 0x202a, 0x202e }, { 0x203f, 0x2040 }, { 0x2054, 0x2054 }, { 0x2060, 0x206f },
+    { 0x2070, 0x218f }, { 0x2460, 0x24ff }, { 0x2776, 0x2793 }, { 0x2c00, 0x2dff }, { 0x2e80, 0x2fff },
+    { 0x3004, 0x3007 }, { 0x3021, 0x302f }, { 0x3031, 0x303f }, { 0x3040, 0xd7ff },
+    { 0xf900, 0xfd3d }, { 0xfd40, 0xfdcf }, { 0xfdf0, 0xfe44 }, { 0xfe47, 0xfffd },
+    { 0x10000, 0x1fffd }, { 0x20000, 0x2fffd }, { 0x30000, 0x3fffd }, { 0x40000, 0x4fffd },
+    { 0x50000, 0x5fffd }, { 0x60000, 0x6fffd }, { 0x70000, 0x7fffd }, { 0x80000, 0x8fffd },
+    { 0x90000, 0x9fffd }, { 0xa0000, 0xafffd }, { 0xb0000, 0xbfffd }, { 0xc0000, 0xcfffd },
+    { 0xd0000, 0xdfffd }, { 0xe0000, 0xefffd }
+};
+
+// The combining marks of C++11 [charname.disallowed], which may not come first
+static const uint32_t notFirstRanges[][2] = {
+    { 0x300, 0x36f }, { 0x1dc0, 0x1dff }, { 0x20d0, 0x20ff }, { 0xfe20, 0xfe2f }
+};
+
+static bool isInRanges(uint32_t codePoint, const uint32_t (*ranges)[2], size_t count) {
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (codePoint > ranges[middle][1])
+            low = middle + 1;
+        else if (codePoint < ranges[middle][0])
+            high = middle;
+        else
+            return true;
+    }
+    return false;
+}
+
+bool _isIdentifierStart(uint32_t codePoint) {
+    if (codePoint < 0x80)
+        return (codePoint >= 'a' && codePoint <= 'z') || (codePoint >= 'A' && codePoint <= 'Z') || codePoint == '_';
+
+    return isInRanges(codePoint, allowedRanges, sizeof allowedRanges / sizeof allowedRanges[0])
+        && !isInRanges(codePoint, notFirstRanges, sizeof notFirstRanges / sizeof notFirstRanges[0]);
+}
+
+bool _isIdentifierPart(uint32_t codePoint) {
+    if (codePoint < 0x80)
+        return _isIdentifierStart(codePoint) || (codePoint >= '0' && codePoint <= '9');
+
+    return isInRanges(codePoint, allowedRanges, sizeof allowedRanges / sizeof allowedRanges[0]);
+}
+
+}
@@ -0,0 +1,27 @@
+#ifndef __Scaly__Utf8__
+#define __Scaly__Utf8__
+namespace scaly {
+
+// Validation, decoding and classification of UTF-8 text. Validation uses the
+// lookup tables of Keiser and Lemire with AVX2 if the CPU has it, which is
+// detected on first use. Otherwise ASCII is skipped 16 bytes at a time.
+
+// Whether the length bytes at data are well formed UTF-8, which excludes
+// overlong forms, surrogates and code points beyond U+10FFFF
+bool _isValidUtf8(const char* data, size_t length);
+
+// The number of code points in the length bytes at data, which must be valid UTF-8
+size_t _countCodePoints(const char* data, size_t length);
+
+// Stores the code point at data in codePoint and returns the number of its
+// bytes, or returns 0 if the bytes at data do not start a well formed code point
+size_t _decodeCodePoint(const char* data, size_t length, uint32_t* codePoint);
+
+// Identifiers are made of ASCII letters, digits and _, and beyond ASCII of the
+// code points which C++11 allows in identifiers, so that they can go into
+// generated C++ as they are. Digits and combining marks may not come first.
+bool _isIdentifierStart(uint32_t codePoint);
+bool _isIdentifierPart(uint32_t codePoint);
+
+}
+#endif // __Scaly__Utf8__
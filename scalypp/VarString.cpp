@@ -5,23 +5,24 @@ VarString::VarString()
 : buffer(0), length(0), capacity(0) {
 }
 
-VarString::VarString(const char* theString) {
-    length = strlen(theString);
-    capacity = length;
+VarString::VarString(const char* theString)
+: length(strlen(theString)), capacity(length) {
     buffer = (char*)_getPage()->allocateObject(length + 1);
-    strcpy(buffer, theString);
+    memcpy(buffer, theString, length + 1);
 }
 
 VarString::VarString(VarString* theString)
 : length(theString->length), capacity(length) {
     buffer = (char*)_getPage()->allocateObject(length + 1);
-    strcpy(buffer, theString->buffer);
+    memcpy(buffer, theString->buffer, length);
+    buffer[length] = 0;
 }
 
 VarString::VarString(string* theString)
 : length(theString->getLength()), capacity(length) {
     buffer = (char*)_getPage()->allocateObject(length + 1);
-    strcpy(buffer, theString->getNativeString());
+    memcpy(buffer, theString->getNativeString(), length);
+    buffer[length] = 0;
 }
 
 VarString::VarString(size_t theLength)
@@ -49,28 +50,37 @@ size_t VarString::getLength() {
     return length;
 }
 
+size_t VarString::getHash() {
+    return Hash::of(buffer, length);
+}
+
 bool VarString::operator == (const char* theString){
     return equals(theString);
 }
 
 bool VarString::equals (const char* theString){
-    return strcmp(buffer, theString) == 0;
+    size_t theLength = strlen(theString);
+    return theLength == length && !memcmp(buffer, theString, length);
 }
 
 bool VarString::equals (string* theString){
-    return strcmp(buffer, theString->getNativeString()) == 0;
+    return length == theString->getLength() && !memcmp(buffer, theString->getNativeString(), length);
+}
+
+bool VarString::equals (VarString* theString){
+    return length == theString->length && !memcmp(buffer, theString->buffer, length);
 }
 
 bool VarString::operator != (const char* theString){
-    return strcmp(buffer, theString) != 0;
+    return !equals(theString);
 }
 
 bool VarString::operator == (const VarString& theString){
-    return strcmp(buffer, theString.getNativeString()) == 0;
+    return length == theString.length && !memcmp(buffer, theString.buffer, length);
 }
 
 bool VarString::operator != (const VarString& theString){
-    return strcmp(buffer, theString.getNativeString()) != 0;
+    return !(*this == theString);
 }
 
 char VarString::operator [](size_t i) {
@@ -97,40 +107,63 @@ void VarString::append (char c) {
 }
 
 void VarString::append(const char* theString) {
-    size_t stringLength = strlen(theString);
+    append(theString, strlen(theString));
+}
+
+void VarString::append(const char* data, size_t theLength) {
     if (!buffer) {
-        // Allocate for the char itself and the trailing 0
-        allocate(stringLength + 1);
-        length = stringLength;
+        // Allocate for the data and the trailing 0
+        allocate(theLength + 1);
+        length = theLength;
         capacity = length;
     }
     else {
-        if (!extend(stringLength))
-            reallocate(length + stringLength);
+        if (!extend(theLength))
+            reallocate(length + theLength);
     }
 
-    strcpy(buffer + length - stringLength, theString);
+    memcpy(buffer + length - theLength, data, theLength);
     *(buffer + length) = 0;
-
 }
 
 void VarString::append(VarString* theString) {
-    append(theString->buffer);
+    append(theString->buffer, theString->length);
 }
 
 void VarString::append(string* theString) {
-    append(theString->getNativeString());
+    append(theString->getNativeString(), theString->getLength());
+}
+
+void VarString::appendDecimal(size_t number) {
+    char digits[Number::maxLength];
+    append(digits, Number::writeDecimal(digits, number) - digits);
+}
+
+void VarString::appendSigned(long long number) {
+    char digits[Number::maxLength];
+    append(digits, Number::writeSigned(digits, number) - digits);
+}
+
+void VarString::appendHex(size_t number) {
+    char digits[Number::maxLength];
+    append(digits, Number::writeHex(digits, number) - digits);
+}
+
+void VarString::appendFloat(double number) {
+    char digits[Number::maxLength];
+    append(digits, Number::writeFloat(digits, number) - digits);
 }
 
 bool VarString::extend(size_t size) {
     _Page& page = *_Page::getPage(buffer);
-    if (length + size < capacity) {
+    if (length + size <= capacity) {
         length += size;
         return true;
     }
-    if (page.extend(buffer + length + 1, size + 1)) {
+    // The buffer ends after the capacity and the trailing 0
+    if (page.extend(buffer + capacity + 1, length + size - capacity)) {
         length += size;
-        capacity += size;
+        capacity = length;
         return true;
     }
     else {
@@ -157,27 +190,15 @@ void VarString::allocate(size_t size) {
 
 _Array<VarString>& VarString::Split(_Page* _rp, char c) {
     _Array<VarString>* ret = new(_rp) _Array<VarString>();
-    VarString* part = 0;
-    for (size_t _i = 0; _i < length; _i++) {
-        char currentChar = (*this)[_i];
-        if (currentChar == c) {
-            if (part) {
-                ret->push(part);
-                part = 0;
-            }
-        }
-        else {
-            if (!part)
-                part = new(_rp) VarString();
-            part->append((*this)[_i]);
-        }
+    _Slice rest(this);
+    _Slice part;
+    while (rest.split(c, &part)) {
+        VarString* item = new(_rp) VarString();
+        item->append(part.getData(), part.getLength());
+        ret->push(item);
     }
 
-    if (part)
-        ret->push(part);
-
     return *ret;
 }
 
 }
-
@@ -13,14 +13,21 @@ public:
     VarString(char c);
     char* getNativeString() const;
     size_t getLength();
+    size_t getHash();
     char operator [](size_t i);
     void append(char c);
     void append(const char* theString);
+    void append(const char* data, size_t theLength);
     void append(VarString* theString);
     void append(string* theString);
+    void appendDecimal(size_t number);
+    void appendSigned(long long number);
+    void appendHex(size_t number);
+    void appendFloat(double number);
     bool operator == (const char* theString);
     bool equals(const char* theString);
     bool equals(string* theString);
+    bool equals(VarString* theString);
     bool operator != (const char* theString);
     bool operator == (const VarString& theString);
     bool operator != (const VarString& theString);
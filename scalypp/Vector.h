@@ -0,0 +1,100 @@
+#ifndef __Scaly__Vector__
+#define __Scaly__Vector__
+#include "Scaly.h"
+namespace scaly {
+
+// Unlike _Array, a _Vector stores its values inline, so T has to be trivially copyable
+template<class T> class _Vector : public Object {
+    static_assert(std::is_trivially_copyable<T>::value, "_Vector elements must be trivially copyable");
+
+public:
+    _Vector<T>()
+    :_size(0), _capacity(0), _rawArray(0) {}
+
+    _Vector<T>(size_t capacity)
+    : _size(0), _capacity(0), _rawArray(0) {
+        reserve(capacity);
+    }
+
+    _Vector<T>(_Vector<T>* vector)
+    : _size(0), _capacity(0), _rawArray(0) {
+        reserve(vector->length());
+        _size = vector->length();
+        memcpy(_rawArray, vector->getRawArray(), _size * sizeof(T));
+    }
+
+    T* operator [](size_t i) {
+        if (i < _size)
+            return _rawArray + i;
+
+        return 0;
+    }
+
+    size_t length() {
+        return _size;
+    }
+
+    size_t capacity() {
+        return _capacity;
+    }
+
+    T* getRawArray() {
+        return _rawArray;
+    }
+
+    // The values form a contiguous span from begin to end
+    T* begin() {
+        return _rawArray;
+    }
+
+    T* end() {
+        return _rawArray + _size;
+    }
+
+    // Append a value to the vector
+    void push(T item) {
+        if (_size == _capacity)
+            grow(_capacity ? _capacity * 2 : 4);
+
+        _rawArray[_size] = item;
+        _size += 1;
+    }
+
+    // Make room for at least capacity values
+    void reserve(size_t capacity) {
+        if (capacity > _capacity)
+            grow(capacity);
+    }
+
+    void clear() {
+        _size = 0;
+    }
+
+private:
+
+    void grow(size_t newCapacity) {
+        // Try to extend the raw array in place if it was the last thing allocated on its page
+        if (_rawArray && _Page::getPage(_rawArray)->extend(_rawArray + _capacity, (newCapacity - _capacity) * sizeof(T))) {
+            _capacity = newCapacity;
+            return;
+        }
+
+        T* oldArray = _rawArray;
+        _capacity = newCapacity;
+        _rawArray = (T*) _getPage()->allocateObject(_capacity * sizeof(T));
+        if (!oldArray)
+            return;
+        memcpy(_rawArray, oldArray, _size * sizeof(T));
+
+        // Reclaim the page if it was oversized, i.e., exclusively allocated
+        if (((Object*)oldArray)->_getPage()->isOversized())
+            _getPage()->reclaimArray(oldArray);
+    }
+
+    size_t _size;
+    size_t _capacity;
+    T* _rawArray;
+};
+
+}
+#endif//__Scaly__Vector__